@@ -0,0 +1,287 @@
+/***************************************************************************//**
+* @file    hdc1000_bench.c
+* @version 1.0.0
+*
+* @brief Benchmark of HDC1000 driver read paths against simulated device.
+*
+* @par Description
+*    Runs public API calls from hdc1000.h for each acquisition mode,
+*    resolution and DRDYn setting and reports per call:
+*      lat_us   - virtual time from call start to return
+*      msgs     - platform callback invocations
+*      xfers    - I2C transactions
+*      bytes    - bytes on bus including address bytes
+*      sleep_us - time requested by delay messages
+*      wait_us  - time blocked in DRDYn edge waits
+*      host_ns  - host CPU time spent in driver and simulator
+*
+*    Then reports throughput of hdc1000_convert_batch() per output format
+*    and of hdc1000_convert_lut() for low resolution modes.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "hdc1000.h"
+#include "hdc1000_sim.h"
+
+/*******************************************************************************
+* Macros and types
+*******************************************************************************/
+
+#define BENCH_ITERATIONS    10000
+
+#define BATCH_SAMPLES       (1 << 20)
+#define BATCH_ROUNDS        20
+
+#define DRDYN_NONE          0   // Delay based wait
+#define DRDYN_POLL          1   // DRDYn pin, level reads only
+#define DRDYN_EDGE          2   // DRDYn pin with edge wait support
+
+typedef struct
+{
+    const char *name;
+    uint8_t mode;
+    uint8_t resolution;
+} bench_config_t;
+
+typedef struct
+{
+    const char *name;
+    uint8_t needs_both;         // Requires HDC1000_CFG_BOTH_TEMP_HUMI
+    void (*run)(hdc1000_t *p_hdc);
+} bench_op_t;
+
+/*******************************************************************************
+* Benchmarked operations
+*******************************************************************************/
+
+static volatile double sink;
+
+static void
+op_temp(hdc1000_t *p_hdc)
+{
+    sink = hdc1000_get_temp(p_hdc);
+}
+
+static void
+op_temp_centi(hdc1000_t *p_hdc)
+{
+    sink = hdc1000_get_temp_centi(p_hdc);
+}
+
+static void
+op_humi(hdc1000_t *p_hdc)
+{
+    sink = hdc1000_get_humi(p_hdc);
+}
+
+static void
+op_temp_then_humi(hdc1000_t *p_hdc)
+{
+    sink = hdc1000_get_temp(p_hdc) + hdc1000_get_humi(p_hdc);
+}
+
+static void
+op_temp_humi(hdc1000_t *p_hdc)
+{
+    double temp;
+    double humi;
+
+    hdc1000_get_temp_humi(p_hdc, &temp, &humi);
+    sink = temp + humi;
+}
+
+static void
+op_dev_id(hdc1000_t *p_hdc)
+{
+    sink = hdc1000_get_dev_id(p_hdc);
+}
+
+static void
+op_battery(hdc1000_t *p_hdc)
+{
+    sink = hdc1000_get_battery_status(p_hdc);
+}
+
+static const bench_config_t configs[] = {
+    { "single 14/14", HDC1000_CFG_SINGLE_MEASUR, HDC1000_CFG_TEMP_HUMI_14BIT },
+    { "single 11/11", HDC1000_CFG_SINGLE_MEASUR, 
+        HDC1000_CFG_TEMP_11BIT | HDC1000_CFG_HUMI_11BIT },
+    { "single 11/8",  HDC1000_CFG_SINGLE_MEASUR,
+        HDC1000_CFG_TEMP_11BIT | HDC1000_CFG_HUMI_8BIT },
+    { "both 14/14",   HDC1000_CFG_BOTH_TEMP_HUMI, HDC1000_CFG_TEMP_HUMI_14BIT },
+    { "both 11/11",   HDC1000_CFG_BOTH_TEMP_HUMI,
+        HDC1000_CFG_TEMP_11BIT | HDC1000_CFG_HUMI_11BIT },
+    { "both 11/8",    HDC1000_CFG_BOTH_TEMP_HUMI,
+        HDC1000_CFG_TEMP_11BIT | HDC1000_CFG_HUMI_8BIT },
+};
+
+static const bench_op_t ops[] = {
+    { "get_temp",          0, op_temp },
+    { "get_temp_centi",    0, op_temp_centi },
+    { "get_humi",          0, op_humi },
+    { "get_temp+get_humi", 0, op_temp_then_humi },
+    { "get_temp_humi",     1, op_temp_humi },
+    { "get_dev_id",        0, op_dev_id },
+    { "get_battery",       0, op_battery },
+};
+
+static const char *drdyn_names[] = { "delay", "poll", "edge" };
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+
+static uint64_t
+host_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void
+bench_run(const bench_config_t *p_cfg, const bench_op_t *p_op, int drdyn)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc;
+    uint64_t start_us;
+    uint64_t start_ns;
+    uint64_t host_ns;
+    int i;
+
+    hdc1000_sim_init(&sim);
+    sim.edge_events = (drdyn == DRDYN_EDGE);
+
+    p_hdc = hdc1000_sim_open(&sim, (drdyn == DRDYN_NONE) ? -1 : 0);
+    if (p_hdc == NULL)
+    {
+        return;
+    }
+
+    hdc1000_set_config(p_hdc, 0, p_cfg->mode, p_cfg->resolution,
+        HDC1000_CFG_HEAT_OFF);
+
+    // Single measured call for virtual time and bus cost
+    hdc1000_sim_reset_stats(&sim);
+    start_us = sim.now_us;
+    p_op->run(p_hdc);
+
+    printf("%-13s %-6s %-18s %8llu %5u %5u %5u %8llu %8llu",
+        p_cfg->name, drdyn_names[drdyn], p_op->name,
+        (unsigned long long)(sim.now_us - start_us), sim.msg_count,
+        sim.transactions, sim.bus_bytes, 
+        (unsigned long long)sim.sleep_us, (unsigned long long)sim.wait_us);
+
+    // Repeated calls for host CPU cost
+    start_ns = host_time_ns();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        p_op->run(p_hdc);
+    }
+    host_ns = (host_time_ns() - start_ns) / BENCH_ITERATIONS;
+
+    printf(" %8llu%s\n", (unsigned long long)host_ns,
+        (sim.nacks > 0) ? "  NACK" : "");
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+bench_batch(void)
+{
+    static uint16_t temp_raw[BATCH_SAMPLES];
+    static uint16_t humi_raw[BATCH_SAMPLES];
+    static double temp_out[BATCH_SAMPLES];
+    static double humi_out[BATCH_SAMPLES];
+    static const char *format_names[] = { "float", "double", "centi" };
+    static const uint8_t lut_res[] = {
+        HDC1000_CFG_TEMP_11BIT | HDC1000_CFG_HUMI_11BIT,
+        HDC1000_CFG_TEMP_11BIT | HDC1000_CFG_HUMI_8BIT
+    };
+    static const char *lut_names[] = { "centi lut 11/11", "centi lut 11/8" };
+    uint64_t start_ns;
+    uint64_t elapsed_ns;
+    uint8_t format;
+    int round;
+    int i;
+
+    for (i = 0; i < BATCH_SAMPLES; i++)
+    {
+        temp_raw[i] = (uint16_t)(i * 7919);
+        humi_raw[i] = (uint16_t)(i * 104729);
+    }
+
+    printf("\n%-22s %12s\n", "convert_batch format", "Msamples/s");
+
+    for (format = HDC1000_FMT_FLOAT; format <= HDC1000_FMT_CENTI; format++)
+    {
+        start_ns = host_time_ns();
+        for (round = 0; round < BATCH_ROUNDS; round++)
+        {
+            hdc1000_convert_batch(temp_raw, humi_raw, BATCH_SAMPLES, format,
+                temp_out, humi_out);
+        }
+        elapsed_ns = host_time_ns() - start_ns;
+
+        // Each sample is one temperature and one humidity value
+        printf("%-22s %12.1f\n", format_names[format],
+            (double)BATCH_SAMPLES * BATCH_ROUNDS * 1000.0 / 
+            (double)elapsed_ns);
+    }
+
+    for (i = 0; i < (int)(sizeof(lut_res) / sizeof(lut_res[0])); i++)
+    {
+        start_ns = host_time_ns();
+        for (round = 0; round < BATCH_ROUNDS; round++)
+        {
+            hdc1000_convert_lut(temp_raw, humi_raw, BATCH_SAMPLES, lut_res[i],
+                (int16_t *)temp_out, (uint16_t *)humi_out);
+        }
+        elapsed_ns = host_time_ns() - start_ns;
+
+        printf("%-22s %12.1f\n", lut_names[i],
+            (double)BATCH_SAMPLES * BATCH_ROUNDS * 1000.0 / 
+            (double)elapsed_ns);
+    }
+}
+
+int
+main(void)
+{
+    size_t c;
+    size_t o;
+    int drdyn;
+
+    printf("%-13s %-6s %-18s %8s %5s %5s %5s %8s %8s %8s\n",
+        "config", "drdyn", "operation", "lat_us", "msgs", "xfers", "bytes",
+        "sleep_us", "wait_us", "host_ns");
+
+    for (c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        for (drdyn = DRDYN_NONE; drdyn <= DRDYN_EDGE; drdyn++)
+        {
+            for (o = 0; o < sizeof(ops) / sizeof(ops[0]); o++)
+            {
+                if (ops[o].needs_both && 
+                    configs[c].mode != HDC1000_CFG_BOTH_TEMP_HUMI)
+                {
+                    continue;
+                }
+                bench_run(&configs[c], &ops[o], drdyn);
+            }
+        }
+    }
+
+    bench_batch();
+    return 0;
+}
+
+/* [] END OF FILE */
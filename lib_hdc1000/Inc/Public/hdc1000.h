@@ -35,24 +35,147 @@
 #define HDC1000_REG_MFID				0xFE
 #define HDC1000_REG_DEVID				0xFF
 
+#define HDC1000_MFID_TI					0x5449
+#define HDC1000_DEVID					0x1000
+
 #define HDC1000_CFG_RST					0x80
 #define	HDC1000_CFG_HEAT_ON				0x20
 #define	HDC1000_CFG_HEAT_OFF			0x00
 #define	HDC1000_CFG_BOTH_TEMP_HUMI		0x10
 #define	HDC1000_CFG_SINGLE_MEASUR		0x00
 #define	HDC1000_CFG_TEMP_HUMI_14BIT		0x00
-#define	HDC1000_CFG_TEMP_11BIT			0x40
+#define	HDC1000_CFG_TEMP_11BIT			0x04
 #define HDC1000_CFG_HUMI_11BIT			0x01
 #define	HDC1000_CFG_HUMI_8BIT			0x02
 
+#define HDC1000_CFG_BTST				0x08	// Read-only battery status
+#define HDC1000_CFG_HEAT_MASK			0x20
+#define HDC1000_CFG_MODE_MASK			0x10
+#define HDC1000_CFG_TEMP_RES_MASK		0x04
+#define HDC1000_CFG_HUMI_RES_MASK		0x03
+#define HDC1000_CFG_RES_MASK			0x07
+
+// Configuration register (MSB) value after power-up or soft reset
+#define HDC1000_CFG_DEFAULT				HDC1000_CFG_BOTH_TEMP_HUMI
+
+// Conversion times in microseconds (datasheet typical values)
+#define HDC1000_CONV_TIME_TEMP_14BIT	6350
+#define HDC1000_CONV_TIME_TEMP_11BIT	3650
+#define HDC1000_CONV_TIME_HUMI_14BIT	6500
+#define HDC1000_CONV_TIME_HUMI_11BIT	3850
+#define HDC1000_CONV_TIME_HUMI_8BIT		2500
+
+// Safety margin added to every conversion wait, in microseconds
+#ifndef HDC1000_CONV_TIME_MARGIN_US
+#define HDC1000_CONV_TIME_MARGIN_US		500
+#endif
+
 #define HDC1000_MSG_I2C_READ_BYTE		0
 #define HDC1000_MSG_I2C_READ_BYTES		1
 #define HDC1000_MSG_I2C_WRITE_BYTE		2
+#define HDC1000_MSG_I2C_WRITE_BYTES		3	// arg_int: length, arg_ptr: data
+#define HDC1000_MSG_I2C_RECOVER			4	// Bus recovery after failed transfer
 
 #define HDC1000_MSG_DELAY_MILLI			10
+#define HDC1000_MSG_DELAY_MICRO			11	// arg_ptr: uint32_t *microseconds
+#define HDC1000_MSG_GET_TIME_MICRO		12	// arg_ptr: uint64_t *monotonic time
 
 #define HDC1000_MSG_GPIO_MODE_INPUT		20
 #define HDC1000_MSG_GPIO_GET_VALUE		21
+#define HDC1000_MSG_GPIO_WAIT_FALLING	22	// arg_ptr: uint32_t *timeout usec
+
+#define HDC1000_MSG_TRANSACTION			30	// arg_int: count, arg_ptr: segments
+
+// Segment types of HDC1000_MSG_TRANSACTION, see hdc1000_segment_t
+#define HDC1000_SEG_WRITE				0	// Write length bytes of data
+#define HDC1000_SEG_READ				1	// Read length bytes to data
+#define HDC1000_SEG_DELAY				2	// Sleep for usec
+#define HDC1000_SEG_WAIT_DRDYN			3	// Wait DRDYn LOW, usec timeout
+
+// Platform callback return values, non-negative value means success.
+// Messages added to the original I2C, delay and GPIO set (I2C_WRITE_BYTES,
+// I2C_RECOVER, DELAY_MICRO, GET_TIME_MICRO, GPIO_WAIT_FALLING, TRANSACTION)
+// are done only if HDC1000_CB_OK is returned. Callbacks unaware of them
+// return other non-negative values, which count as unsupported.
+#define HDC1000_CB_OK					0
+#define HDC1000_CB_ERROR				-1
+#define HDC1000_CB_TIMEOUT				-2
+#define HDC1000_CB_UNSUPPORTED			-3
+
+// Status codes of hdc1000_read_*() functions
+#define HDC1000_OK						0
+#define HDC1000_ERR_IO					HDC1000_CB_ERROR
+#define HDC1000_ERR_TIMEOUT				HDC1000_CB_TIMEOUT
+#define HDC1000_ERR_UNSUPPORTED			HDC1000_CB_UNSUPPORTED
+#define HDC1000_ERR_NOT_READY			-4	// No completed measurement
+#define HDC1000_ERR_DEVICE				-5	// Unexpected device identity
+#define HDC1000_ERR_MODE				-6	// Wrong acquisition mode set
+#define HDC1000_ERR_ARG					-7	// Invalid argument
+
+// Default retry policy, see hdc1000_set_retry()
+#ifndef HDC1000_RETRY_COUNT
+#define HDC1000_RETRY_COUNT				0
+#endif
+
+#ifndef HDC1000_RETRY_BACKOFF_US
+#define HDC1000_RETRY_BACKOFF_US		1000
+#endif
+
+// Upper bound of exponentially growing retry backoff in microseconds
+#define HDC1000_RETRY_BACKOFF_MAX_US	100000
+
+// DRDYn wait timeout as a multiple of expected conversion time
+#ifndef HDC1000_DRDYN_TIMEOUT_FACTOR
+#define HDC1000_DRDYN_TIMEOUT_FACTOR	4
+#endif
+
+// Number of DRDYn reads before polling wait falls back to sleeping
+#ifndef HDC1000_DRDYN_SPIN_POLLS
+#define HDC1000_DRDYN_SPIN_POLLS		16
+#endif
+
+// Polling wait sleep interval bounds in microseconds
+#define HDC1000_DRDYN_SLEEP_MIN_US		50
+#define HDC1000_DRDYN_SLEEP_MAX_US		1000
+
+// Output formats of hdc1000_convert_batch()
+#define HDC1000_FMT_FLOAT				0
+#define HDC1000_FMT_DOUBLE				1
+#define HDC1000_FMT_CENTI				2
+
+// Register value shift giving the table index of hdc1000_lut_* tables
+#define HDC1000_LUT_SHIFT_11BIT			5
+#define HDC1000_LUT_SHIFT_8BIT			8
+
+// Filter channels, see hdc1000_filter_raw()
+#define HDC1000_FILTER_TEMP				0
+#define HDC1000_FILTER_HUMI				1
+
+// Longest running median window of hdc1000_set_filter()
+#ifndef HDC1000_FILTER_MEDIAN_MAX
+#define HDC1000_FILTER_MEDIAN_MAX		5
+#endif
+
+// Compile-time platform binding for builds linking a single backend.
+// Define HDC1000_PLATFORM_CB to the name of the platform callback and the
+// driver calls it directly instead of through hdc1000_t platform_cb.
+// HDC1000_PLATFORM_HEADER may name a header with static inline definition
+// of that callback, then message dispatch is resolved at compile time.
+
+// Number of hdc1000_t in static device pool, 0 allocates from heap
+#ifndef HDC1000_POOL_SIZE
+#define HDC1000_POOL_SIZE				0
+#endif
+
+// Owner of hdc1000_t memory
+#define HDC1000_STORAGE_HEAP			0
+#define HDC1000_STORAGE_POOL			1
+#define HDC1000_STORAGE_CALLER			2
+
+// Split-phase measurement states
+#define HDC1000_STATE_IDLE				0
+#define HDC1000_STATE_BUSY				1
+#define HDC1000_STATE_READY				2
 
 
 
@@ -69,6 +192,39 @@ extern "C" {
 
 typedef struct hdc1000_struct hdc1000_t;
 
+typedef struct {
+    uint16_t mf_id;             // Manufacturer ID
+    uint16_t dev_id;            // Device ID
+    uint16_t serid[3];          // Serial ID registers 0xFB - 0xFD
+    uint64_t serial_id;         // 40-bit serial number
+} hdc1000_identity_t;
+
+/// <summary>
+///		Step of a register access passed by HDC1000_MSG_TRANSACTION
+/// <para>The platform runs all segments in order within one callback and
+/// may merge a write followed by a read into one bus transfer with
+/// repeated start. It stops at the first failing segment and returns
+/// HDC1000_CB_ERROR, or HDC1000_CB_TIMEOUT if DRDYn wait expired.
+/// Platforms that cannot run every segment type return
+/// HDC1000_CB_UNSUPPORTED before touching the bus, the driver then uses
+/// single-step messages. Platforms declare support with
+/// hdc1000_set_transaction().</para>
+/// </summary>
+typedef struct {
+    uint8_t type;               // HDC1000_SEG_*
+    uint8_t length;             // Bytes to write or read
+    uint8_t *data;              // Write data or read buffer
+    uint32_t usec;              // Delay or DRDYn wait timeout
+} hdc1000_segment_t;
+
+typedef struct {
+    uint16_t window[HDC1000_FILTER_MEDIAN_MAX]; // Last median inputs
+    uint8_t window_pos;         // Slot of next median input
+    uint8_t window_fill;        // Valid entries in window
+    uint8_t ema_valid;          // EMA holds a value
+    uint32_t ema;               // EMA of raw words, 16 fraction bits
+} hdc1000_filter_state_t;
+
 typedef int(*hdc1000_msg_cb)(hdc1000_t *p_hdc, uint8_t msg, 
     uint8_t arg_int, void *arg_ptr);
 
@@ -76,21 +232,92 @@ struct hdc1000_struct {
     uint8_t i2c_addr;
     int drdyn_pin;
     hdc1000_msg_cb platform_cb;
+    void *user_data;            // Platform dependent per-device data
+    uint8_t config;             // Shadow of configuration register MSB
+    uint8_t btst;               // Battery status from last config read
+    uint64_t btst_read_us;      // Time of last config read
+    uint32_t btst_max_age_us;   // Max age of cached battery status
+    uint8_t meas_state;         // Split-phase measurement state
+    uint8_t meas_reg;           // Register addressed by pending measurement
+    uint64_t meas_ready_us;     // Pending measurement completion time
+    uint64_t meas_deadline_us;  // Pending measurement DRDYn timeout
+    hdc1000_identity_t identity;    // Cached identity registers
+    uint8_t identity_valid;     // Identity cache holds device values
+    uint8_t retries;            // Retries of a failed register access
+    uint32_t retry_backoff_us;  // Delay before first retry
+    uint32_t timeout_us;        // Time budget per call, 0 for unlimited
+    uint64_t deadline_us;       // Deadline of call in progress
+    uint8_t storage;            // HDC1000_STORAGE_* owner of this struct
+    uint8_t transaction;        // Platform runs HDC1000_MSG_TRANSACTION,
+                                // see hdc1000_set_transaction()
+    uint8_t filter_oversample;  // Conversions averaged per read
+    uint8_t filter_median;      // Running median window, 1 for none
+    uint8_t filter_ema_shift;   // EMA weight 2^-shift, 0 for none
+    uint8_t filter_hold;        // Values bypass filters, hdc1000_hold_filter()
+    hdc1000_filter_state_t filter[2];   // Per HDC1000_FILTER_* channel
 };
 
 hdc1000_t 
 *hdc1000_init(uint8_t ad, int dp, hdc1000_msg_cb platform_cb);
 
+hdc1000_t 
+*hdc1000_init_user(uint8_t ad, int dp, hdc1000_msg_cb platform_cb,
+	void *user_data);
+
+hdc1000_t
+*hdc1000_init_static(hdc1000_t *p_hdc, uint8_t ad, int dp,
+	hdc1000_msg_cb platform_cb, void *user_data);
+
 void 
 hdc1000_shutdown(hdc1000_t *p_hdc);
 	
-void 
+int 
 hdc1000_set_config(hdc1000_t *p_hdc, uint8_t r, uint8_t m,
 	uint8_t res, uint8_t h);
 
 uint16_t 
 hdc1000_get_config(hdc1000_t *p_hdc);
 
+int
+hdc1000_set_heater(hdc1000_t *p_hdc, uint8_t heater);
+
+int
+hdc1000_set_mode(hdc1000_t *p_hdc, uint8_t mode);
+
+int
+hdc1000_set_resolution(hdc1000_t *p_hdc, uint8_t resolution);
+
+void
+hdc1000_set_btst_max_age(hdc1000_t *p_hdc, uint32_t max_age_us);
+
+void
+hdc1000_set_retry(hdc1000_t *p_hdc, uint8_t retries, uint32_t backoff_us);
+
+void
+hdc1000_set_timeout(hdc1000_t *p_hdc, uint32_t timeout_us);
+
+void
+hdc1000_set_transaction(hdc1000_t *p_hdc, uint8_t enable);
+
+void
+hdc1000_set_filter(hdc1000_t *p_hdc, uint8_t oversample, uint8_t median,
+	uint8_t ema_shift);
+
+void
+hdc1000_reset_filter(hdc1000_t *p_hdc);
+
+void
+hdc1000_hold_filter(hdc1000_t *p_hdc, uint8_t hold);
+
+uint16_t
+hdc1000_filter_raw(hdc1000_t *p_hdc, uint8_t channel, uint16_t raw);
+
+int
+hdc1000_read_config(hdc1000_t *p_hdc, uint16_t *p_config);
+
+uint32_t
+hdc1000_get_conversion_time(hdc1000_t *p_hdc, uint8_t reg_addr);
+
 uint16_t 
 hdc1000_get_temp_raw(hdc1000_t *p_hdc);
 
@@ -103,6 +330,100 @@ hdc1000_get_humi_raw(hdc1000_t *p_hdc);
 double 
 hdc1000_get_humi(hdc1000_t *p_hdc);
 
+int16_t
+hdc1000_get_temp_centi(hdc1000_t *p_hdc);
+
+uint16_t
+hdc1000_get_humi_centi(hdc1000_t *p_hdc);
+
+int16_t
+hdc1000_temp_raw_to_centi(uint16_t raw);
+
+uint16_t
+hdc1000_humi_raw_to_centi(uint16_t raw);
+
+void
+hdc1000_get_temp_humi_raw(hdc1000_t *p_hdc, uint16_t *p_temp, 
+	uint16_t *p_humi);
+
+void
+hdc1000_get_temp_humi(hdc1000_t *p_hdc, double *p_temp, double *p_humi);
+
+int
+hdc1000_read_temp_raw(hdc1000_t *p_hdc, uint16_t *p_raw);
+
+int
+hdc1000_read_temp(hdc1000_t *p_hdc, double *p_temp);
+
+int
+hdc1000_read_humi_raw(hdc1000_t *p_hdc, uint16_t *p_raw);
+
+int
+hdc1000_read_humi(hdc1000_t *p_hdc, double *p_humi);
+
+int
+hdc1000_read_temp_centi(hdc1000_t *p_hdc, int16_t *p_temp);
+
+int
+hdc1000_read_humi_centi(hdc1000_t *p_hdc, uint16_t *p_humi);
+
+int
+hdc1000_read_temp_humi_raw(hdc1000_t *p_hdc, uint16_t *p_temp,
+	uint16_t *p_humi);
+
+int
+hdc1000_read_temp_humi(hdc1000_t *p_hdc, double *p_temp, double *p_humi);
+
+int
+hdc1000_convert_batch(const uint16_t *p_temp_raw, const uint16_t *p_humi_raw,
+	size_t count, uint8_t format, void *p_temp_out, void *p_humi_out);
+
+// Hundredths of degC or %RH by low resolution code, see hdc1000_lut.c
+extern const int16_t hdc1000_lut_temp_11bit[2048];
+extern const uint16_t hdc1000_lut_humi_11bit[2048];
+extern const uint16_t hdc1000_lut_humi_8bit[256];
+
+void
+hdc1000_convert_lut(const uint16_t *p_temp_raw, const uint16_t *p_humi_raw,
+	size_t count, uint8_t resolution, int16_t *p_temp_centi,
+	uint16_t *p_humi_centi);
+
+int16_t
+hdc1000_dew_point_centi(uint16_t temp_raw, uint16_t humi_raw);
+
+uint32_t
+hdc1000_abs_humi_centi(uint16_t temp_raw, uint16_t humi_raw);
+
+int16_t
+hdc1000_heat_index_centi(uint16_t temp_raw, uint16_t humi_raw);
+
+void
+hdc1000_psychro_batch(const uint16_t *p_temp_raw, const uint16_t *p_humi_raw,
+	size_t count, int16_t *p_dew_point, uint32_t *p_abs_humi,
+	int16_t *p_heat_index);
+
+int
+hdc1000_start_measurement(hdc1000_t *p_hdc, uint8_t reg_addr);
+
+int
+hdc1000_poll(hdc1000_t *p_hdc, uint32_t *p_remaining_us);
+
+int
+hdc1000_fetch(hdc1000_t *p_hdc, uint16_t *p_temp, uint16_t *p_humi);
+
+int
+hdc1000_read_group(hdc1000_t **pp_hdc, size_t count, uint8_t reg_addr,
+	uint16_t *p_temp, uint16_t *p_humi, int *p_status);
+
+int
+hdc1000_refresh_identity(hdc1000_t *p_hdc);
+
+const hdc1000_identity_t
+*hdc1000_get_identity(hdc1000_t *p_hdc);
+
+uint64_t
+hdc1000_get_serial_id(hdc1000_t *p_hdc);
+
 uint16_t 
 hdc1000_get_dev_id(hdc1000_t *p_hdc);
 
@@ -112,6 +433,9 @@ hdc1000_get_mf_id(hdc1000_t *p_hdc);
 uint8_t 
 hdc1000_get_battery_status(hdc1000_t *p_hdc);
 
+int
+hdc1000_read_battery_status(hdc1000_t *p_hdc, uint8_t *p_btst);
+
 #ifdef __cplusplus
 }
 #endif
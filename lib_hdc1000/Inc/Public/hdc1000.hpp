@@ -0,0 +1,295 @@
+/***************************************************************************//**
+* @file    hdc1000.hpp
+* @version 1.0.0
+*
+* @brief Header-only C++ wrapper for TI HDC1000 sensor.
+*
+* @par Description
+*    hdc1000::Sensor owns one hdc1000_t for its lifetime. Platform backend,
+*    resolution and acquisition mode are template parameters, so register
+*    configuration, conversion times and unit conversions are compile-time
+*    constants and every call is a direct call of the C driver.
+*
+*    Backends for the platform wrappers are available when the wrapper
+*    header is included before this one:
+*        lib_hdc1000.h       - hdc1000::AzureSphereBackend
+*        lib_hdc1000_linux.h - hdc1000::LinuxBackend
+*        hdc1000_sim.h       - hdc1000::SimBackend
+*
+*    To inline platform calls into the driver as well, build the C driver
+*    with HDC1000_PLATFORM_CB, see hdc1000.h.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#ifndef __HDC1000_HPP__
+#define __HDC1000_HPP__
+
+/*******************************************************************************
+*   Included Headers
+*******************************************************************************/
+#include <utility>
+
+#include "hdc1000.h"
+
+namespace hdc1000 {
+
+/*******************************************************************************
+*   Configuration
+*******************************************************************************/
+
+enum class Mode : uint8_t {
+    Single = HDC1000_CFG_SINGLE_MEASUR,     // Temperature or humidity
+    Combined = HDC1000_CFG_BOTH_TEMP_HUMI   // Temperature and humidity
+};
+
+enum class TempRes : uint8_t {
+    Bits14 = HDC1000_CFG_TEMP_HUMI_14BIT,
+    Bits11 = HDC1000_CFG_TEMP_11BIT
+};
+
+enum class HumiRes : uint8_t {
+    Bits14 = HDC1000_CFG_TEMP_HUMI_14BIT,
+    Bits11 = HDC1000_CFG_HUMI_11BIT,
+    Bits8 = HDC1000_CFG_HUMI_8BIT
+};
+
+/// <summary>
+///     Measurement resolution of temperature and humidity
+/// </summary>
+template <TempRes T = TempRes::Bits14, HumiRes H = HumiRes::Bits14>
+struct Resolution {
+    static constexpr TempRes temp = T;
+    static constexpr HumiRes humi = H;
+    static constexpr uint8_t config =
+        static_cast<uint8_t>(T) | static_cast<uint8_t>(H);
+
+    static constexpr uint32_t temp_time_us = (T == TempRes::Bits11) ?
+        HDC1000_CONV_TIME_TEMP_11BIT : HDC1000_CONV_TIME_TEMP_14BIT;
+    static constexpr uint32_t humi_time_us = (H == HumiRes::Bits8) ?
+        HDC1000_CONV_TIME_HUMI_8BIT : (H == HumiRes::Bits11) ?
+        HDC1000_CONV_TIME_HUMI_11BIT : HDC1000_CONV_TIME_HUMI_14BIT;
+};
+
+/*******************************************************************************
+*   Units
+*******************************************************************************/
+
+/// <summary>
+///     Temperature in degrees Celsius
+/// </summary>
+struct Celsius {
+    double value;
+
+    constexpr explicit Celsius(double v = 0.0) : value(v) {}
+
+    /// <summary>
+    ///     Convert Temperature register value, same as the C driver
+    /// </summary>
+    static constexpr Celsius from_raw(uint16_t raw) {
+        return Celsius(((static_cast<double>(raw) / 65536.0) * 165.0)
+            - 40.0);
+    }
+};
+
+/// <summary>
+///     Relative Humidity in %RH
+/// </summary>
+struct RelHumidity {
+    double value;
+
+    constexpr explicit RelHumidity(double v = 0.0) : value(v) {}
+
+    /// <summary>
+    ///     Convert Humidity register value, same as the C driver
+    /// </summary>
+    static constexpr RelHumidity from_raw(uint16_t raw) {
+        return RelHumidity((static_cast<double>(raw) / 65536.0) * 100.0);
+    }
+};
+
+static_assert(Celsius::from_raw(0).value == -40.0,
+    "Temperature conversion");
+static_assert(RelHumidity::from_raw(32768).value == 50.0,
+    "Humidity conversion");
+
+/*******************************************************************************
+*   Backends
+*******************************************************************************/
+
+// Backend is a class with static open() returning hdc1000_t pointer or
+// nullptr, and static close() releasing it.
+
+#ifdef LIBHDC1000_H
+struct AzureSphereBackend {
+    static hdc1000_t *open(int i2c_fd, I2C_DeviceAddress i2c_addr,
+        int drdyn_pin = -1) {
+        return hdc1000_open(i2c_fd, i2c_addr, drdyn_pin);
+    }
+    static void close(hdc1000_t *p_hdc) { hdc1000_close(p_hdc); }
+};
+#endif
+
+#ifdef LIBHDC1000_LINUX_H
+struct LinuxBackend {
+    static hdc1000_t *open(const char *i2c_dev,
+        uint8_t i2c_addr = HDC1000_I2C_ADDR,
+        const char *gpiochip_dev = nullptr, int drdyn_line = -1) {
+        return hdc1000_linux_open(i2c_dev, i2c_addr, gpiochip_dev,
+            drdyn_line);
+    }
+    static void close(hdc1000_t *p_hdc) { hdc1000_linux_close(p_hdc); }
+};
+#endif
+
+#ifdef __HDC1000_SIM_H__
+struct SimBackend {
+    static hdc1000_t *open(hdc1000_sim_t *p_sim, int drdyn_pin = -1) {
+        return hdc1000_sim_open(p_sim, drdyn_pin);
+    }
+    static void close(hdc1000_t *p_hdc) { hdc1000_sim_close(p_hdc); }
+};
+#endif
+
+/*******************************************************************************
+*   Sensor
+*******************************************************************************/
+
+/// <summary>
+///     HDC1000 sensor owning its driver instance
+/// <para>Constructor opens the device through Backend and writes the
+/// configuration register, destructor closes it. Use the valid() check
+/// before reading, error() tells why construction failed. Read functions
+/// return HDC1000_OK or negative status of the C driver and leave outputs
+/// unchanged on failure.</para>
+/// <para>Configuration must not be changed through get() handle,
+/// conversion times would no longer match.</para>
+/// </summary>
+template <class Backend, class Res = Resolution<>,
+    Mode M = Mode::Combined>
+class Sensor {
+public:
+    static constexpr Mode mode = M;
+    static constexpr uint8_t config = static_cast<uint8_t>(M) | Res::config;
+
+    // Time from trigger to result of a temperature or humidity read
+    static constexpr uint32_t temp_time_us = HDC1000_CONV_TIME_MARGIN_US +
+        ((M == Mode::Combined) ? Res::temp_time_us + Res::humi_time_us :
+        Res::temp_time_us);
+    static constexpr uint32_t humi_time_us = HDC1000_CONV_TIME_MARGIN_US +
+        ((M == Mode::Combined) ? Res::temp_time_us + Res::humi_time_us :
+        Res::humi_time_us);
+
+    template <class... Args>
+    explicit Sensor(Args &&...args)
+        : p_hdc_(Backend::open(std::forward<Args>(args)...)),
+          error_(HDC1000_ERR_IO) {
+        if (p_hdc_ != nullptr) {
+            error_ = hdc1000_set_config(p_hdc_, 0, static_cast<uint8_t>(M),
+                Res::config, HDC1000_CFG_HEAT_OFF);
+            // Conversion times would not match an unknown configuration
+            if (error_ != HDC1000_OK) {
+                Backend::close(p_hdc_);
+                p_hdc_ = nullptr;
+            }
+        }
+    }
+
+    ~Sensor() {
+        if (p_hdc_ != nullptr) {
+            Backend::close(p_hdc_);
+        }
+    }
+
+    Sensor(const Sensor &) = delete;
+    Sensor &operator=(const Sensor &) = delete;
+
+    Sensor(Sensor &&other) noexcept
+        : p_hdc_(other.p_hdc_), error_(other.error_) {
+        other.p_hdc_ = nullptr;
+    }
+
+    Sensor &operator=(Sensor &&other) noexcept {
+        std::swap(p_hdc_, other.p_hdc_);
+        std::swap(error_, other.error_);
+        return *this;
+    }
+
+    bool valid() const noexcept { return p_hdc_ != nullptr; }
+
+    /// <summary>
+    ///     Status of construction
+    /// </summary>
+    /// <returns>HDC1000_OK, HDC1000_ERR_IO if Backend failed to open or
+    /// status of writing the configuration register</returns>
+    int error() const noexcept { return error_; }
+
+    /// <summary>
+    ///     Underlying C driver handle
+    /// </summary>
+    hdc1000_t *get() const noexcept { return p_hdc_; }
+
+    int read(Celsius &temp) {
+        uint16_t raw;
+        int result = hdc1000_read_temp_raw(p_hdc_, &raw);
+
+        if (result == HDC1000_OK) {
+            temp = Celsius::from_raw(raw);
+        }
+        return result;
+    }
+
+    int read(RelHumidity &humi) {
+        uint16_t raw;
+        int result = hdc1000_read_humi_raw(p_hdc_, &raw);
+
+        if (result == HDC1000_OK) {
+            humi = RelHumidity::from_raw(raw);
+        }
+        return result;
+    }
+
+    /// <summary>
+    ///     Read both values, from one acquisition in combined mode
+    /// </summary>
+    int read(Celsius &temp, RelHumidity &humi) {
+        uint16_t temp_raw;
+        uint16_t humi_raw;
+        int result;
+
+        if (M == Mode::Combined) {
+            result = hdc1000_read_temp_humi_raw(p_hdc_, &temp_raw,
+                &humi_raw);
+        } else {
+            result = hdc1000_read_temp_raw(p_hdc_, &temp_raw);
+            if (result == HDC1000_OK) {
+                result = hdc1000_read_humi_raw(p_hdc_, &humi_raw);
+            }
+        }
+
+        if (result == HDC1000_OK) {
+            temp = Celsius::from_raw(temp_raw);
+            humi = RelHumidity::from_raw(humi_raw);
+        }
+        return result;
+    }
+
+    /// <summary>
+    ///     Turn heater on or off, see hdc1000_set_heater()
+    /// </summary>
+    int set_heater(bool on) {
+        return hdc1000_set_heater(p_hdc_,
+            on ? HDC1000_CFG_HEAT_ON : HDC1000_CFG_HEAT_OFF);
+    }
+
+private:
+    hdc1000_t *p_hdc_;
+    int error_;
+};
+
+} // namespace hdc1000
+
+#endif // __HDC1000_HPP__
+/* [] END OF FILE */
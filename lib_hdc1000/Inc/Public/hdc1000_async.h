@@ -0,0 +1,84 @@
+/***************************************************************************//**
+* @file    hdc1000_async.h
+* @version 1.0.0
+*
+* @brief Event loop integration for HDC1000 sensor.
+*
+* @par Description
+*    Declarations of the asynchronous measurement interface. Functions
+*    declared here are implemented by the platform dependent wrapper, which
+*    owns the pollable file descriptor.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+
+#ifndef __HDC1000_ASYNC_H__
+#define __HDC1000_ASYNC_H__
+
+/*******************************************************************************
+*   Included Headers
+*******************************************************************************/
+#include "hdc1000.h"
+
+/*******************************************************************************
+*   Function Declarations
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// <summary>
+///     Measurement completion callback
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="status">HDC1000_OK on success, negative status of
+/// hdc1000_poll() or hdc1000_fetch() on failure</param>
+/// <param name="temp_raw">Temperature register value, if measured</param>
+/// <param name="humi_raw">Humidity register value, if measured</param>
+/// <param name="context">Context passed to hdc1000_async_start()</param>
+typedef void(*hdc1000_ready_cb)(hdc1000_t *p_hdc, int status,
+    uint16_t temp_raw, uint16_t humi_raw, void *context);
+
+/// <summary>
+///     Get file descriptor which becomes readable when a measurement
+///     started by hdc1000_async_start() is ready to be handled
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <returns>Pollable file descriptor or -1 if not available</returns>
+int
+hdc1000_async_get_fd(hdc1000_t *p_hdc);
+
+/// <summary>
+///     Trigger a measurement and return immediately
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="reg_addr">HDC1000_REG_TEMP or HDC1000_REG_HUMI</param>
+/// <param name="ready_cb">Completion callback</param>
+/// <param name="context">Context passed to completion callback</param>
+/// <returns>0 on success, -1 if measurement could not be triggered
+/// </returns>
+int
+hdc1000_async_start(hdc1000_t *p_hdc, uint8_t reg_addr,
+    hdc1000_ready_cb ready_cb, void *context);
+
+/// <summary>
+///     Handle readable event on descriptor from hdc1000_async_get_fd()
+/// <para>Invokes completion callback once the measurement is finished or
+/// has failed, e.g. DRDYn did not go LOW within the timeout of
+/// hdc1000_poll(), otherwise rearms the descriptor and returns.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <returns>1 if measurement completed, 0 if still pending,
+/// -1 on failure</returns>
+int
+hdc1000_async_handle_event(hdc1000_t *p_hdc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HDC1000_ASYNC_H__
+/* [] END OF FILE */
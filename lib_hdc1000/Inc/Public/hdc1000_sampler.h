@@ -0,0 +1,147 @@
+/***************************************************************************//**
+* @file    hdc1000_sampler.h
+* @version 1.0.0
+*
+* @brief Background continuous sampler for HDC1000 sensor.
+*
+* @par Description
+*    Sampler thread acquires measurements at a fixed rate and publishes
+*    timestamped samples into a single-producer/single-consumer lock-free
+*    ring buffer. Consumer drains samples without waiting on the bus.
+*    Optional heater schedule runs heated conversions in the idle time
+*    between samples and marks or drops samples affected by heating.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#ifndef __HDC1000_SAMPLER_H__
+#define __HDC1000_SAMPLER_H__
+
+/*******************************************************************************
+*   Included Headers
+*******************************************************************************/
+#include "hdc1000.h"
+
+/*******************************************************************************
+*   Macros and #define Constants
+*******************************************************************************/
+
+// Sample flags
+#define HDC1000_SAMPLE_HEATED			0x01	// Taken in heater burst or blackout
+
+// Handling of samples affected by heater, see hdc1000_sampler_set_heater()
+#define HDC1000_HEATER_MARK				0
+#define HDC1000_HEATER_SUPPRESS			1
+
+/*******************************************************************************
+*   Types
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint64_t timestamp_us;      // Monotonic time of acquisition start
+    uint16_t temp_raw;          // Temperature register value
+    uint16_t humi_raw;          // Humidity register value
+    uint8_t flags;              // HDC1000_SAMPLE_* flags
+} hdc1000_sample_t;
+
+typedef struct hdc1000_sampler_struct hdc1000_sampler_t;
+
+/*******************************************************************************
+*   Function Declarations
+*******************************************************************************/
+
+/// <summary>
+///     Create sampler for an initialized device
+/// <para>While the sampler is running it has exclusive use of the device.
+/// </para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="period_us">Sampling period in microseconds, non-zero
+/// </param>
+/// <param name="capacity">Ring buffer size in samples, power of two</param>
+/// <returns>Pointer to sampler or NULL on failure</returns>
+hdc1000_sampler_t
+*hdc1000_sampler_create(hdc1000_t *p_hdc, uint32_t period_us,
+    uint32_t capacity);
+
+/// <summary>
+///     Stop sampler if running and free its resources
+/// <para>Device itself is not closed.</para>
+/// </summary>
+/// <param name="p_sampler">Pointer to sampler</param>
+void
+hdc1000_sampler_destroy(hdc1000_sampler_t *p_sampler);
+
+/// <summary>
+///     Set periodic heater schedule
+/// <para>Each cycle starts with a heater burst of duty percent of the cycle
+/// period. Heater is active only during conversions, so in the burst the
+/// idle time between samples is filled with heated conversions, sampling
+/// rate stays unchanged. Samples taken in the burst and in the blackout
+/// following it read high temperature and low humidity, they are kept out
+/// of the device filters, see hdc1000_hold_filter().</para>
+/// <para>Can be set only while sampler is stopped.</para>
+/// </summary>
+/// <param name="p_sampler">Pointer to sampler</param>
+/// <param name="cycle_us">Heater cycle period, 0 disables heater</param>
+/// <param name="duty">Heater burst length in percent of cycle period
+/// </param>
+/// <param name="blackout_us">Time after burst for the sensor to cool down
+/// </param>
+/// <param name="mode">HDC1000_HEATER_MARK to flag affected samples with
+/// HDC1000_SAMPLE_HEATED, HDC1000_HEATER_SUPPRESS to drop them</param>
+/// <returns>0 on success, -1 on failure</returns>
+int
+hdc1000_sampler_set_heater(hdc1000_sampler_t *p_sampler, uint32_t cycle_us,
+    uint8_t duty, uint32_t blackout_us, uint8_t mode);
+
+/// <summary>
+///     Start sampler thread
+/// </summary>
+/// <param name="p_sampler">Pointer to sampler</param>
+/// <returns>0 on success, -1 if already running, sampling period is 0
+/// or the thread could not be created</returns>
+int
+hdc1000_sampler_start(hdc1000_sampler_t *p_sampler);
+
+/// <summary>
+///     Stop sampler thread and wait for it to finish
+/// <para>Sleeping thread is woken at once, an acquisition in progress
+/// is completed first.</para>
+/// </summary>
+/// <param name="p_sampler">Pointer to sampler</param>
+void
+hdc1000_sampler_stop(hdc1000_sampler_t *p_sampler);
+
+/// <summary>
+///     Move up to max_samples oldest samples out of the ring buffer
+/// <para>Never blocks. Must be called from a single consumer thread.</para>
+/// </summary>
+/// <param name="p_sampler">Pointer to sampler</param>
+/// <param name="p_samples">Output array</param>
+/// <param name="max_samples">Output array size</param>
+/// <returns>Number of samples stored to output array</returns>
+size_t
+hdc1000_sampler_drain(hdc1000_sampler_t *p_sampler,
+    hdc1000_sample_t *p_samples, size_t max_samples);
+
+/// <summary>
+///     Get number of samples dropped because the ring buffer was full
+/// </summary>
+/// <param name="p_sampler">Pointer to sampler</param>
+/// <returns>Dropped samples count</returns>
+uint32_t
+hdc1000_sampler_dropped(hdc1000_sampler_t *p_sampler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HDC1000_SAMPLER_H__
+/* [] END OF FILE */
@@ -0,0 +1,121 @@
+/***************************************************************************//**
+* @file    hdc1000_sim.h
+* @version 1.0.0
+*
+* @brief Simulated HDC1000 device for host testing and benchmarking.
+*
+* @par Description
+*    Register accurate model of HDC1000 implementing hdc1000_msg_cb on
+*    a virtual clock. Delays advance the virtual clock instead of sleeping,
+*    so driver runs are deterministic and take no wall time.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#ifndef __HDC1000_SIM_H__
+#define __HDC1000_SIM_H__
+
+/*******************************************************************************
+*   Included Headers
+*******************************************************************************/
+#include "hdc1000.h"
+
+/*******************************************************************************
+*   Macros and #define Constants
+*******************************************************************************/
+#define HDC1000_SIM_MFID				0x5449
+#define HDC1000_SIM_DEVID				0x1000
+
+// Configuration register bits (full 16-bit register)
+#define HDC1000_SIM_CFG_RST				0x8000
+#define HDC1000_SIM_CFG_HEAT			0x2000
+#define HDC1000_SIM_CFG_MODE			0x1000
+#define HDC1000_SIM_CFG_BTST			0x0800
+#define HDC1000_SIM_CFG_TRES			0x0400
+#define HDC1000_SIM_CFG_HRES			0x0300
+
+/*******************************************************************************
+*   Types
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hdc1000_sim_struct hdc1000_sim_t;
+
+struct hdc1000_sim_struct {
+    // Device registers
+    uint8_t i2c_addr;
+    uint8_t pointer;            // Register address pointer
+    uint16_t temp_reg;
+    uint16_t humi_reg;
+    uint16_t config_reg;
+    uint16_t serid[3];
+
+    // Conversion in progress
+    uint8_t conv_regs;          // Bit 0 temperature, bit 1 humidity
+    uint64_t conv_start_us;
+    uint64_t conv_end_us;
+
+    // Environment
+    double ambient_temp;        // Degrees Celsius
+    double ambient_humi;        // %RH
+    double vdd;                 // Supply voltage
+    double heater_rise;         // Self heating above ambient temperature
+    double heater_rate;         // Heating in degC/s while converting
+    double cool_rate;           // Cooling in degC/s
+    uint8_t edge_events;        // Non-zero to support GPIO_WAIT_FALLING
+    uint8_t drdyn_configured;   // DRDYn GPIO set as input
+    uint8_t transaction_msgs;   // Non-zero to support MSG_TRANSACTION
+
+    // Virtual clock and bus timing
+    uint64_t now_us;
+    uint32_t bus_hz;            // I2C clock, 0 for zero time transfers
+    uint32_t gpio_read_us;      // Cost of one DRDYn read
+
+    // Fault injection
+    uint32_t fail_next;         // Number of following I2C transfers to fail
+    uint8_t bus_stuck;          // Fail all I2C transfers until recovery
+    uint8_t drdyn_stuck;        // DRDYn stays HIGH
+
+    // Statistics
+    uint32_t msg_count;         // Platform callback invocations
+    uint32_t transactions;      // I2C transactions
+    uint32_t bus_bytes;         // Bytes on bus including address bytes
+    uint32_t nacks;             // NACKed transactions
+    uint32_t recoveries;        // Bus recovery requests
+    uint64_t sleep_us;          // Time spent in delay messages
+    uint64_t wait_us;           // Time spent in DRDYn waits
+};
+
+/*******************************************************************************
+*   Function Declarations
+*******************************************************************************/
+
+void
+hdc1000_sim_init(hdc1000_sim_t *p_sim);
+
+hdc1000_t
+*hdc1000_sim_open(hdc1000_sim_t *p_sim, int drdyn_pin);
+
+void
+hdc1000_sim_close(hdc1000_t *p_hdc);
+
+int
+hdc1000_sim_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int, 
+    void *arg_ptr);
+
+void
+hdc1000_sim_advance(hdc1000_sim_t *p_sim, uint64_t usec);
+
+void
+hdc1000_sim_reset_stats(hdc1000_sim_t *p_sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HDC1000_SIM_H__
+/* [] END OF FILE */
@@ -0,0 +1,63 @@
+/***************************************************************************//**
+* @file    hdc1000_sim_inline.h
+* @version 1.0.0
+*
+* @brief Simulator platform callback for compile-time binding.
+*
+* @par Description
+*    Platform header for building hdc1000.c with
+*    -DHDC1000_PLATFORM_CB=hdc1000_sim_inline_cb and
+*    -DHDC1000_PLATFORM_HEADER='"hdc1000_sim_inline.h"'. Clock and delay
+*    messages, sent between bus transfers, are served inline from the
+*    virtual clock. Other messages go to hdc1000_sim_cb().
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#ifndef __HDC1000_SIM_INLINE_H__
+#define __HDC1000_SIM_INLINE_H__
+
+/*******************************************************************************
+*   Included Headers
+*******************************************************************************/
+#include "hdc1000_sim.h"
+
+/*******************************************************************************
+*   Function Definitions
+*******************************************************************************/
+
+/// <summary>
+///		Platform callback serving driver messages from simulated device
+/// <para>Counts messages and sleep time as hdc1000_sim_cb() does.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct, user_data has
+/// to point to hdc1000_sim_t</param>
+/// <returns>Non-negative on success, HDC1000_CB_* on failure</returns>
+static inline int
+hdc1000_sim_inline_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int,
+    void *arg_ptr)
+{
+    hdc1000_sim_t *p_sim = (hdc1000_sim_t *)p_hdc->user_data;
+
+    switch (msg)
+    {
+    case HDC1000_MSG_DELAY_MICRO:
+        p_sim->msg_count++;
+        p_sim->sleep_us += *(uint32_t *)arg_ptr;
+        hdc1000_sim_advance(p_sim, *(uint32_t *)arg_ptr);
+        return HDC1000_CB_OK;
+
+    case HDC1000_MSG_GET_TIME_MICRO:
+        p_sim->msg_count++;
+        *(uint64_t *)arg_ptr = p_sim->now_us;
+        return HDC1000_CB_OK;
+
+    default:
+        return hdc1000_sim_cb(p_hdc, msg, arg_int, arg_ptr);
+    }
+}
+
+#endif // __HDC1000_SIM_INLINE_H__
+/* [] END OF FILE */
@@ -18,6 +18,7 @@
 *   Included Headers
 *******************************************************************************/
 #include "hdc1000.h"
+#include "hdc1000_async.h"
 
 /*******************************************************************************
 *   Macros and #define Constants
@@ -30,6 +31,13 @@
 
 #define SK_MT3620_DRDY_GPIO 2
 
+// Delay before each I2C write transaction in microseconds, works around
+// I2C write issue of Azure Sphere OS 19.11. Set to 0 for later OS versions
+// or change at runtime using hdc1000_set_write_delay().
+#ifndef HDC1000_WRITE_DELAY_US
+#define HDC1000_WRITE_DELAY_US 800
+#endif
+
 
 /*******************************************************************************
 *   Function Declarations
@@ -56,6 +64,14 @@ hdc1000_t
 void
 hdc1000_close(hdc1000_t* __phdc);
 
+/// <summary>
+///     Set delay performed before each I2C write transaction
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="usec">Delay in microseconds, 0 to disable</param>
+void
+hdc1000_set_write_delay(hdc1000_t *p_hdc, uint32_t usec);
+
 #ifdef __cplusplus
 }
 #endif
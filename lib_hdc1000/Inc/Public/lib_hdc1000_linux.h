@@ -0,0 +1,61 @@
+/***************************************************************************//**
+* @file    lib_hdc1000_linux.h
+* @version 1.0.0
+*
+* @brief Linux platform wrapper for HDC1000 sensor.
+*
+* @par Description
+*    Uses i2c-dev (/dev/i2c-N) for bus access and GPIO character device
+*    (/dev/gpiochipN) line events for DRDYn signal.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#ifndef LIBHDC1000_LINUX_H
+#define LIBHDC1000_LINUX_H
+
+/*******************************************************************************
+*   Included Headers
+*******************************************************************************/
+#include "hdc1000.h"
+#include "hdc1000_async.h"
+
+/*******************************************************************************
+*   Function Declarations
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// <summary>
+///		Initialize HDC1000 sensor and associated resources
+/// </summary>
+/// <param name="i2c_dev">I2C bus device path, e.g. "/dev/i2c-1"</param>
+/// <param name="i2c_addr">The address of the HDC1000 I2C device</param>
+/// <param name="gpiochip_dev">GPIO chip device path, e.g. 
+///							"/dev/gpiochip0", or NULL if DRDYn is not used
+/// </param>
+/// <param name="drdyn_line">DRDYn signal line offset on GPIO chip
+///							or -1 if not used. If the line cannot be
+///							requested DRDYn is not used.</param>
+/// <returns>Pointer to hdc1000_t data structure</returns>
+hdc1000_t
+*hdc1000_linux_open(const char *i2c_dev, uint8_t i2c_addr,
+    const char *gpiochip_dev, int drdyn_line);
+
+/// <summary>
+///     Free HDC1000 associated resources
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+void
+hdc1000_linux_close(hdc1000_t *p_hdc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBHDC1000_LINUX_H
+
+/* [] END OF FILE */
@@ -19,18 +19,105 @@
 
 #include <unistd.h>
 
+#ifdef HDC1000_PLATFORM_HEADER
+#include HDC1000_PLATFORM_HEADER
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+// Platform callback bound at compile time is called directly
+#ifdef HDC1000_PLATFORM_CB
+#define PLATFORM_CALL(p_hdc, msg, arg_int, arg_ptr) \
+	HDC1000_PLATFORM_CB((p_hdc), (msg), (arg_int), (arg_ptr))
+#else
+#define PLATFORM_CALL(p_hdc, msg, arg_int, arg_ptr) \
+	(*(p_hdc)->platform_cb)((p_hdc), (msg), (arg_int), (arg_ptr))
+#endif
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+
+#if HDC1000_POOL_SIZE > 0
+static hdc1000_t hdc1000_pool[HDC1000_POOL_SIZE];
+static uint8_t hdc1000_pool_used[HDC1000_POOL_SIZE];
+#endif
+
 /*******************************************************************************
 * Forward declarations of private functions
 *******************************************************************************/
 
-static void 
+#if defined(HDC1000_PLATFORM_CB) && !defined(HDC1000_PLATFORM_HEADER)
+int
+HDC1000_PLATFORM_CB(hdc1000_t* p_hdc, uint8_t msg, uint8_t arg_int,
+	void* arg_ptr);
+#endif
+
+static hdc1000_t
+*hdc1000_alloc(void);
+
+static void
+hdc1000_free(hdc1000_t* p_hdc);
+
+static int 
 hdc1000_set_reg_addr(hdc1000_t* p_hdc, uint8_t reg_addr);
 
+static int
+hdc1000_write_config(hdc1000_t* p_hdc, uint8_t config);
+
+static int
+hdc1000_write_config_bytes(hdc1000_t* p_hdc, uint8_t config);
+
+static int
+hdc1000_update_config(hdc1000_t* p_hdc, uint8_t mask, uint8_t value);
+
+static int
+hdc1000_drdyn_timeout(hdc1000_t* p_hdc, uint32_t conv_time,
+	uint32_t* p_timeout);
+
+static int
+hdc1000_wait_drdyn(hdc1000_t* p_hdc, uint32_t conv_time);
+
+static int
+hdc1000_poll_drdyn(hdc1000_t* p_hdc, uint32_t conv_time, uint32_t timeout);
+
+static int
+hdc1000_read_register(hdc1000_t* p_hdc, uint8_t reg_addr, uint8_t* buffer,
+	uint8_t length);
+
+static int
+hdc1000_access_register(hdc1000_t* p_hdc, uint8_t reg_addr,
+	uint32_t conv_time, uint8_t* buffer, uint8_t length);
+
+static int
+hdc1000_read_words(hdc1000_t* p_hdc, uint8_t reg_addr, uint16_t* words,
+	uint8_t count);
+
+static int
+hdc1000_begin_call(hdc1000_t* p_hdc);
+
+static int
+hdc1000_retry(hdc1000_t* p_hdc, uint8_t* p_attempt, uint32_t attempt_us);
+
+static double
+hdc1000_temp_from_raw(uint16_t raw);
+
+static double
+hdc1000_humi_from_raw(uint16_t raw);
+
+static int16_t
+hdc1000_temp_centi_from_raw(hdc1000_t* p_hdc, uint16_t raw);
+
 static uint16_t
-hdc1000_get_register(hdc1000_t* p_hdc);
+hdc1000_humi_centi_from_raw(hdc1000_t* p_hdc, uint16_t raw);
+
+static int
+hdc1000_delay_us(hdc1000_t* p_hdc, uint32_t usec);
 
 static int
-hdc1000_delay(hdc1000_t* p_hdc, uint8_t msg, uint8_t arg);
+hdc1000_get_time_us(hdc1000_t* p_hdc, uint64_t* p_now);
 
 static int 
 hdc1000_gpio(hdc1000_t* p_hdc, uint8_t msg, uint8_t arg_int, void *arg_ptr);
@@ -38,16 +125,23 @@ hdc1000_gpio(hdc1000_t* p_hdc, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 static int 
 hdc1000_i2c_write(hdc1000_t* p_hdc, uint8_t arg);
 
+static int 
+hdc1000_i2c_write_bytes(hdc1000_t* p_hdc, uint8_t* buffer, uint8_t length);
+
 static int 
 hdc1000_i2c_read_bytes(hdc1000_t* p_hdc, uint8_t* buffer, uint8_t length);
 
+static int
+hdc1000_i2c_recover(hdc1000_t* p_hdc);
+
 /*******************************************************************************
 * Public functions
 *******************************************************************************/
 
 /// <summary>
 ///		Initialize HDC1000 and allocate resources
-/// <para>Memory resources are allocated from heap, to properly free
+/// <para>Memory resources are allocated from heap, or from static device
+/// pool if HDC1000_POOL_SIZE is defined non-zero. To properly free
 /// allocated memory use hdc1000_shutdown()</para>
 /// </summary>
 /// <param name="i2c_addr">HDC1000 I2C address</param>
@@ -58,13 +152,61 @@ hdc1000_i2c_read_bytes(hdc1000_t* p_hdc, uint8_t* buffer, uint8_t length);
 hdc1000_t 
 *hdc1000_init(uint8_t i2c_addr, int drdyn_pin, hdc1000_msg_cb platform_cb) 
 {
+	return hdc1000_init_user(i2c_addr, drdyn_pin, platform_cb, NULL);
+}
+
+/// <summary>
+///		Initialize HDC1000 with platform dependent per-device data
+/// <para>User data is stored in hdc1000_t before the first platform
+/// callback invocation and is available to it as p_hdc->user_data.</para>
+/// </summary>
+/// <param name="i2c_addr">HDC1000 I2C address</param>
+/// <param name="drdyn_pin">DRDYn pin number or -1 if not used</param>
+/// <param name="platform_cb">Hardware dependent functions callback</param>
+/// <param name="user_data">Platform dependent per-device data</param>
+/// <returns>Pointer to hdc1000_t data structure</returns>
+hdc1000_t 
+*hdc1000_init_user(uint8_t i2c_addr, int drdyn_pin, 
+	hdc1000_msg_cb platform_cb, void *user_data) 
+{
+	hdc1000_t *p_hdc = hdc1000_alloc();
+	uint8_t storage;
 
-	hdc1000_t *p_hdc = (hdc1000_t *)malloc(sizeof(hdc1000_t));
     if (p_hdc == NULL) 
     {
         return NULL;
     }
 
+	storage = p_hdc->storage;
+	hdc1000_init_static(p_hdc, i2c_addr, drdyn_pin, platform_cb, user_data);
+	p_hdc->storage = storage;
+
+	return p_hdc;
+}
+
+/// <summary>
+///		Initialize HDC1000 in caller provided storage
+/// <para>Does not allocate memory. Storage must stay valid until
+/// hdc1000_shutdown(), which leaves it to the caller.</para>
+/// <para>If the platform fails to configure DRDYn pin as input, drdyn_pin
+/// is set to -1 and conversions are waited for by delay.</para>
+/// </summary>
+/// <param name="p_hdc">Storage for hdc1000_t data struct</param>
+/// <param name="i2c_addr">HDC1000 I2C address</param>
+/// <param name="drdyn_pin">DRDYn pin number or -1 if not used</param>
+/// <param name="platform_cb">Hardware dependent functions callback</param>
+/// <param name="user_data">Platform dependent per-device data</param>
+/// <returns>p_hdc, NULL if no storage was given</returns>
+hdc1000_t
+*hdc1000_init_static(hdc1000_t *p_hdc, uint8_t i2c_addr, int drdyn_pin,
+	hdc1000_msg_cb platform_cb, void *user_data)
+{
+	if (p_hdc == NULL)
+	{
+		return NULL;
+	}
+
+	p_hdc->storage = HDC1000_STORAGE_CALLER;
 	p_hdc->i2c_addr = i2c_addr;
 	if (0 == i2c_addr) 
     {
@@ -73,74 +215,311 @@ hdc1000_t
 
 	p_hdc->drdyn_pin = drdyn_pin;
 	p_hdc->platform_cb = platform_cb;
+	p_hdc->user_data = user_data;
+	p_hdc->config = HDC1000_CFG_DEFAULT;
+	p_hdc->meas_state = HDC1000_STATE_IDLE;
+	p_hdc->meas_reg = HDC1000_REG_TEMP;
+	p_hdc->meas_ready_us = 0;
+	p_hdc->meas_deadline_us = 0;
+	p_hdc->identity_valid = 0;
+	p_hdc->btst = 0;
+	p_hdc->btst_read_us = UINT64_MAX;
+	p_hdc->btst_max_age_us = 0;
+	p_hdc->retries = HDC1000_RETRY_COUNT;
+	p_hdc->retry_backoff_us = HDC1000_RETRY_BACKOFF_US;
+	p_hdc->timeout_us = 0;
+	p_hdc->deadline_us = UINT64_MAX;
+	p_hdc->transaction = 0;
+	p_hdc->filter_hold = 0;
+	hdc1000_set_filter(p_hdc, 1, 1, 0);
 
 	// If using DRDYn pin configure GPIO as Input
-	if (drdyn_pin > -1) 
+	if (drdyn_pin > -1 && hdc1000_gpio(p_hdc, HDC1000_MSG_GPIO_MODE_INPUT,
+		(uint8_t)drdyn_pin, NULL) < 0)
     {
-		// Set MT3620 GPIO pin to Input mode
-		hdc1000_gpio(p_hdc, HDC1000_MSG_GPIO_MODE_INPUT, 
-			(uint8_t)drdyn_pin, NULL);
+		// Unusable pin would fail every wait, use conversion time instead
+		p_hdc->drdyn_pin = -1;
 	}
 
+	// Identity registers never change, read them once
+	hdc1000_refresh_identity(p_hdc);
+
+	// Device may have been configured before, load configuration shadow
+	hdc1000_get_config(p_hdc);
+
 	return p_hdc;
 }
 
 /// <summary>
 ///		Shutdown HDC1000 and free allocated resources
+/// <para>Storage given to hdc1000_init_static() is not freed.</para>
 /// </summary>
 /// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
 ///
 void 
 hdc1000_shutdown(hdc1000_t *p_hdc) 
 {
-	free(p_hdc);
+	hdc1000_free(p_hdc);
 }
 
 /// <summary>
 ///		Set HDC1000 Configuration
+/// <para>Configuration shadow used for conversion times and conversions
+/// is updated only after the device took the write.</para>
 /// </summary>
 /// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
 /// <param name="reset"></param>
 /// <param name="mode"></param>
 /// <param name="resolution"></param>
 /// <param name="heater"></param>
+/// <returns>HDC1000_OK or negative status</returns>
 ///
-void 
+int 
 hdc1000_set_config(hdc1000_t *p_hdc,
 						uint8_t reset, uint8_t mode, 
 						uint8_t resolution, uint8_t heater)
 {
 	uint8_t config = mode | resolution | heater | reset;
+	int result;
+
+	result = hdc1000_begin_call(p_hdc);
+	if (result == HDC1000_OK)
+	{
+		result = hdc1000_write_config(p_hdc, config);
+	}
+	return result;
+}
+
+/// <summary>
+///		Turn heater on or off
+/// <para>Configuration register is written only if the value changes.
+/// </para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="heater">HDC1000_CFG_HEAT_ON or HDC1000_CFG_HEAT_OFF</param>
+/// <returns>1 if configuration was written, 0 if unchanged, negative
+/// status on failure</returns>
+///
+int
+hdc1000_set_heater(hdc1000_t* p_hdc, uint8_t heater)
+{
+	return hdc1000_update_config(p_hdc, HDC1000_CFG_HEAT_MASK, heater);
+}
+
+/// <summary>
+///		Set acquisition mode
+/// <para>Configuration register is written only if the value changes.
+/// </para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="mode">HDC1000_CFG_SINGLE_MEASUR or 
+/// HDC1000_CFG_BOTH_TEMP_HUMI</param>
+/// <returns>1 if configuration was written, 0 if unchanged, negative
+/// status on failure</returns>
+///
+int
+hdc1000_set_mode(hdc1000_t* p_hdc, uint8_t mode)
+{
+	return hdc1000_update_config(p_hdc, HDC1000_CFG_MODE_MASK, mode);
+}
+
+/// <summary>
+///		Set temperature and humidity measurement resolution
+/// <para>Configuration register is written only if the value changes.
+/// </para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="resolution">Combination of HDC1000_CFG_TEMP_* and
+/// HDC1000_CFG_HUMI_* resolution flags</param>
+/// <returns>1 if configuration was written, 0 if unchanged, negative
+/// status on failure</returns>
+///
+int
+hdc1000_set_resolution(hdc1000_t* p_hdc, uint8_t resolution)
+{
+	return hdc1000_update_config(p_hdc, HDC1000_CFG_RES_MASK, resolution);
+}
+
+/// <summary>
+///		Set how long hdc1000_get_battery_status() may use cached BTST
+/// <para>Battery status is cached from every configuration register read.
+/// Default max age 0 reads configuration register on every call.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="max_age_us">Max age in microseconds</param>
+///
+void
+hdc1000_set_btst_max_age(hdc1000_t* p_hdc, uint32_t max_age_us)
+{
+	p_hdc->btst_max_age_us = max_age_us;
+}
+
+/// <summary>
+///		Set retry policy of failed register accesses
+/// <para>Before each retry the platform is asked for I2C bus recovery and
+/// the driver sleeps for backoff, doubled on every further retry up to
+/// HDC1000_RETRY_BACKOFF_MAX_US. Measurement retries trigger a new
+/// conversion.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="retries">Number of retries, 0 disables retrying</param>
+/// <param name="backoff_us">Delay before first retry in microseconds
+/// </param>
+///
+void
+hdc1000_set_retry(hdc1000_t* p_hdc, uint8_t retries, uint32_t backoff_us)
+{
+	p_hdc->retries = retries;
+	p_hdc->retry_backoff_us = backoff_us;
+}
+
+/// <summary>
+///		Set time budget of a single call
+/// <para>Retries which could not complete within the budget are not
+/// started and DRDYn waits are cut short at its end. Budget should
+/// be longer than conversion time of the configured mode.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="timeout_us">Time budget in microseconds, 0 for unlimited
+/// </param>
+///
+void
+hdc1000_set_timeout(hdc1000_t* p_hdc, uint32_t timeout_us)
+{
+	p_hdc->timeout_us = timeout_us;
+}
 
-	hdc1000_i2c_write(p_hdc, HDC1000_REG_CONFIG);
-	hdc1000_i2c_write(p_hdc, config);
-	hdc1000_i2c_write(p_hdc, 0);
+/// <summary>
+///		Declare platform support of HDC1000_MSG_TRANSACTION
+/// <para>Off after init, platform wrappers whose callback runs every
+/// segment type and returns HDC1000_CB_OK on success turn it on.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="enable">1 to hand register accesses over as transactions,
+/// 0 for one message per step</param>
+///
+void
+hdc1000_set_transaction(hdc1000_t* p_hdc, uint8_t enable)
+{
+	p_hdc->transaction = enable ? 1 : 0;
 }
 
 /// <summary>
 ///		Get Configuration
 /// </summary>
 /// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
-/// <returns>Configuration register value</returns>
+/// <returns>Configuration register value, 0 on failure</returns>
 ///
 uint16_t 
 hdc1000_get_config(hdc1000_t* p_hdc) 
 {
-	hdc1000_set_reg_addr(p_hdc, HDC1000_REG_CONFIG);
-	return hdc1000_get_register(p_hdc);
+	uint16_t config = 0;
+
+	hdc1000_read_config(p_hdc, &config);
+	return config;
+}
+
+/// <summary>
+///		Read Configuration register
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_config">Configuration register value output</param>
+/// <returns>HDC1000_OK or negative status</returns>
+///
+int
+hdc1000_read_config(hdc1000_t* p_hdc, uint16_t* p_config)
+{
+	uint8_t bytes[2];
+	uint16_t config;
+	uint64_t now;
+	int result;
+
+	result = hdc1000_begin_call(p_hdc);
+	if (result == HDC1000_OK)
+	{
+		result = hdc1000_read_register(p_hdc, HDC1000_REG_CONFIG, bytes, 2);
+	}
+	if (result != HDC1000_OK)
+	{
+		return result;
+	}
+	config = (uint16_t)((bytes[0] << 8) + bytes[1]);
+
+	// Refresh shadow and battery status cache
+	p_hdc->config = (uint8_t)(config >> 8) & 
+		(uint8_t)~(HDC1000_CFG_RST | HDC1000_CFG_BTST);
+	p_hdc->btst = ((config >> 8) & HDC1000_CFG_BTST) ? 1 : 0;
+	p_hdc->btst_read_us = (hdc1000_get_time_us(p_hdc, &now) == HDC1000_OK) ?
+		now : UINT64_MAX;
+
+	*p_config = config;
+	return HDC1000_OK;
+}
+
+/// <summary>
+///		Get conversion time for a register access
+/// <para>Conversion time depends on acquisition mode and resolution
+/// last set by hdc1000_set_config(). Registers other than temperature
+/// and humidity do not trigger a conversion.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="reg_addr">Address of register to be accessed</param>
+/// <returns>Conversion time in microseconds, 0 if no conversion</returns>
+///
+uint32_t
+hdc1000_get_conversion_time(hdc1000_t* p_hdc, uint8_t reg_addr)
+{
+	uint32_t temp_time = HDC1000_CONV_TIME_TEMP_14BIT;
+	uint32_t humi_time = HDC1000_CONV_TIME_HUMI_14BIT;
+
+	if (reg_addr != HDC1000_REG_TEMP && reg_addr != HDC1000_REG_HUMI)
+	{
+		return 0;
+	}
+
+	if (p_hdc->config & HDC1000_CFG_TEMP_11BIT)
+	{
+		temp_time = HDC1000_CONV_TIME_TEMP_11BIT;
+	}
+
+	switch (p_hdc->config & HDC1000_CFG_HUMI_RES_MASK)
+	{
+	case HDC1000_CFG_HUMI_11BIT:
+		humi_time = HDC1000_CONV_TIME_HUMI_11BIT;
+		break;
+	case HDC1000_CFG_HUMI_8BIT:
+		humi_time = HDC1000_CONV_TIME_HUMI_8BIT;
+		break;
+	default:
+		break;
+	}
+
+	if (p_hdc->config & HDC1000_CFG_BOTH_TEMP_HUMI)
+	{
+		// Temperature and humidity are acquired in sequence
+		return temp_time + humi_time + HDC1000_CONV_TIME_MARGIN_US;
+	}
+
+	if (reg_addr == HDC1000_REG_TEMP)
+	{
+		return temp_time + HDC1000_CONV_TIME_MARGIN_US;
+	}
+	return humi_time + HDC1000_CONV_TIME_MARGIN_US;
 }
 
 /// <summary>
 ///		Get Temperature register
 /// </summary>
 /// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
-/// <returns>Temperature register value</returns>
+/// <returns>Temperature register value, 0 on failure</returns>
 ///
 uint16_t 
 hdc1000_get_temp_raw(hdc1000_t* p_hdc) 
 {
-	hdc1000_set_reg_addr(p_hdc, HDC1000_REG_TEMP);
-	return hdc1000_get_register(p_hdc);
+	uint16_t raw = 0;
+
+	hdc1000_read_temp_raw(p_hdc, &raw);
+	return raw;
 }
 
 /// <summary>
@@ -152,21 +531,22 @@ hdc1000_get_temp_raw(hdc1000_t* p_hdc)
 double 
 hdc1000_get_temp(hdc1000_t* p_hdc) 
 {
-	double temp = (double) hdc1000_get_temp_raw(p_hdc);
-	return ((temp / 65536.0) * 165.0) - 40.0;
+	return hdc1000_temp_from_raw(hdc1000_get_temp_raw(p_hdc));
 }
 
 /// <summary>
 ///		Get Humidity register
 /// </summary>
 /// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
-/// <returns>Humidity register value</returns>
+/// <returns>Humidity register value, 0 on failure</returns>
 ///
 uint16_t 
 hdc1000_get_humi_raw(hdc1000_t* p_hdc) 
 {
-	hdc1000_set_reg_addr(p_hdc, HDC1000_REG_HUMI);
-	return hdc1000_get_register(p_hdc);
+	uint16_t raw = 0;
+
+	hdc1000_read_humi_raw(p_hdc, &raw);
+	return raw;
 }
 
 /// <summary>
@@ -178,132 +558,1581 @@ hdc1000_get_humi_raw(hdc1000_t* p_hdc)
 double 
 hdc1000_get_humi(hdc1000_t* p_hdc) 
 {
-	double temp = (double)hdc1000_get_humi_raw(p_hdc);
-	return (temp / 65536.0) * 100.0;
+	return hdc1000_humi_from_raw(hdc1000_get_humi_raw(p_hdc));
 }
 
 /// <summary>
-///		Get manufacturer ID (= 0x5449)
+///		Get Temperature in hundredths of degree Celsius
+/// <para>Integer only conversion, see hdc1000_temp_raw_to_centi(). In
+/// 11-bit resolution by lookup in hdc1000_lut_temp_11bit, same result.
+/// </para>
 /// </summary>
 /// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
-/// <returns>HDC1000 Manufacturer ID</returns>
+/// <returns>Temperature in 0.01 degrees Celsius</returns>
 ///
-uint16_t 
-hdc1000_get_mf_id(hdc1000_t* p_hdc) 
+int16_t
+hdc1000_get_temp_centi(hdc1000_t* p_hdc)
 {
-	hdc1000_set_reg_addr(p_hdc, HDC1000_REG_MFID);
-	return hdc1000_get_register(p_hdc);
+	return hdc1000_temp_centi_from_raw(p_hdc, hdc1000_get_temp_raw(p_hdc));
 }
 
-///<summary>
-///   Get device ID (= 0x1000)
-///</summary>
+/// <summary>
+///		Get Relative Humidity in hundredths of %RH
+/// <para>Integer only conversion, see hdc1000_humi_raw_to_centi(). In
+/// 11-bit and 8-bit resolution by lookup in hdc1000_lut_humi_*, same
+/// result.</para>
+/// </summary>
 /// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
-/// <returns>HDC1000 Device ID</returns>
+/// <returns>Relative Humidity in 0.01 %RH</returns>
 ///
-uint16_t 
-hdc1000_get_dev_id(hdc1000_t* p_hdc) 
+uint16_t
+hdc1000_get_humi_centi(hdc1000_t* p_hdc)
 {
-	hdc1000_set_reg_addr(p_hdc, HDC1000_REG_DEVID);
-	return hdc1000_get_register(p_hdc);
+	return hdc1000_humi_centi_from_raw(p_hdc, hdc1000_get_humi_raw(p_hdc));
 }
 
 /// <summary>
-///		Get device battery status (BTST)
+///		Convert Temperature register value to hundredths of degree Celsius
+/// <para>Uses 32-bit multiply and shift only. Result is the value of
+/// hdc1000_get_temp() scaled by 100 and rounded to nearest, halves
+/// rounded up, i.e. floor(temp * 100 + 0.5), for every register value.
+/// </para>
 /// </summary>
-/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
-/// <returns>Battery Voltage Status: 0 - over 2.8V, 1 - under 2.8V</returns>
+/// <param name="raw">Temperature register value</param>
+/// <returns>Temperature in 0.01 degrees Celsius, -4000 to 12500</returns>
 ///
-uint8_t 
-hdc1000_get_battery_status(hdc1000_t* p_hdc) 
+int16_t
+hdc1000_temp_raw_to_centi(uint16_t raw)
 {
-	uint16_t config = hdc1000_get_config(p_hdc);
+	// raw * 165 * 100 / 65536 - 40 * 100
+	return (int16_t)((int32_t)(((uint32_t)raw * 16500u + 32768u) >> 16)
+		- 4000);
+}
 
-	if (config & 0x800) 
-    {
-		return 1;
-	}
-	return 0;
+/// <summary>
+///		Convert Humidity register value to hundredths of %RH
+/// <para>Uses 32-bit multiply and shift only. Result is the value of
+/// hdc1000_get_humi() scaled by 100 and rounded to nearest, halves
+/// rounded up, i.e. floor(humi * 100 + 0.5), for every register value.
+/// </para>
+/// </summary>
+/// <param name="raw">Humidity register value</param>
+/// <returns>Relative Humidity in 0.01 %RH, 0 to 10000</returns>
+///
+uint16_t
+hdc1000_humi_raw_to_centi(uint16_t raw)
+{
+	// raw * 100 * 100 / 65536
+	return (uint16_t)(((uint32_t)raw * 10000u + 32768u) >> 16);
 }
 
-/*******************************************************************************
-* Private functions
-*******************************************************************************/
+/// <summary>
+///		Get Temperature and Humidity registers from a single acquisition
+/// <para>Device has to be configured for HDC1000_CFG_BOTH_TEMP_HUMI mode
+/// using hdc1000_set_config() or hdc1000_set_mode(). Both values are
+/// converted in one sequence (temperature first) and read out in one
+/// 4 byte transfer. In single measurement mode both outputs are 0.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_temp">Temperature register value output</param>
+/// <param name="p_humi">Humidity register value output</param>
+///
+void
+hdc1000_get_temp_humi_raw(hdc1000_t* p_hdc, uint16_t* p_temp, 
+	uint16_t* p_humi)
+{
+	if (hdc1000_read_temp_humi_raw(p_hdc, p_temp, p_humi) != HDC1000_OK)
+	{
+		*p_temp = 0;
+		*p_humi = 0;
+	}
+}
 
 /// <summary>
-///		Set register address for subsequent access
+///		Get Temperature and Relative Humidity from a single acquisition
+/// <para>See hdc1000_get_temp_humi_raw() for mode requirements.</para>
 /// </summary>
 /// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
-/// <param name="reg_addr">Address of register to be accessed</param>
-static void
-hdc1000_set_reg_addr(hdc1000_t *p_hdc, uint8_t reg_addr) 
+/// <param name="p_temp">Temperature in degrees Celsius output</param>
+/// <param name="p_humi">Relative Humidity in %RH output</param>
+///
+void
+hdc1000_get_temp_humi(hdc1000_t* p_hdc, double* p_temp, double* p_humi)
 {
-	uint8_t drdyn_state = 1;
+	uint16_t temp_raw;
+	uint16_t humi_raw;
 
-	hdc1000_i2c_write(p_hdc, reg_addr);
+	hdc1000_get_temp_humi_raw(p_hdc, &temp_raw, &humi_raw);
 
-	if (p_hdc->drdyn_pin > -1) 
-    {
-		// Using DRDYn to ack
-		// After measurement is complete DRDYn is set to LOW
-		while (drdyn_state == 1) 
-        {
-			hdc1000_gpio(p_hdc, HDC1000_MSG_GPIO_GET_VALUE, 0, &drdyn_state);
-		}
+	*p_temp = hdc1000_temp_from_raw(temp_raw);
+	*p_humi = hdc1000_humi_from_raw(humi_raw);
+}
+
+/// <summary>
+///		Read Temperature register
+/// <para>Status returning variant of hdc1000_get_temp_raw(). Failed
+/// accesses are retried as set by hdc1000_set_retry() within time budget
+/// set by hdc1000_set_timeout(). Output is left unchanged on failure.
+/// </para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_raw">Temperature register value output</param>
+/// <returns>HDC1000_OK, HDC1000_ERR_IO or HDC1000_ERR_TIMEOUT</returns>
+///
+int
+hdc1000_read_temp_raw(hdc1000_t* p_hdc, uint16_t* p_raw)
+{
+	uint16_t word;
+	int result;
+
+	result = hdc1000_begin_call(p_hdc);
+	if (result == HDC1000_OK)
+	{
+		result = hdc1000_read_words(p_hdc, HDC1000_REG_TEMP, &word, 1);
 	}
-	else 
-    {
-		hdc1000_delay(p_hdc, HDC1000_MSG_DELAY_MILLI, 20);
+	if (result == HDC1000_OK)
+	{
+		*p_raw = hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, word);
 	}
+	return result;
 }
 
 /// <summary>
-///		Gets register value
-///	<para>Register address has to be set by hdc1000_set_reg_addr() first</para>
+///		Read Temperature
+/// <para>See hdc1000_read_temp_raw().</para>
 /// </summary>
 /// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
-/// <returns>Register value</returns>
-/// 
-static uint16_t 
-hdc1000_get_register(hdc1000_t* p_hdc) 
+/// <param name="p_temp">Temperature in degrees Celsius output</param>
+/// <returns>HDC1000_OK or negative status</returns>
+///
+int
+hdc1000_read_temp(hdc1000_t* p_hdc, double* p_temp)
 {
-	uint8_t bytes[2];
+	uint16_t raw;
+	int result = hdc1000_read_temp_raw(p_hdc, &raw);
 
-	hdc1000_i2c_read_bytes(p_hdc, bytes, 2);
-	return (uint16_t)((bytes[0] << 8) + bytes[1]);
+	if (result == HDC1000_OK)
+	{
+		*p_temp = hdc1000_temp_from_raw(raw);
+	}
+	return result;
 }
 
+/// <summary>
+///		Read Humidity register
+/// <para>See hdc1000_read_temp_raw().</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_raw">Humidity register value output</param>
+/// <returns>HDC1000_OK or negative status</returns>
 ///
-///
-static int 
-hdc1000_delay(hdc1000_t* p_hdc, uint8_t msg, uint8_t arg) 
+int
+hdc1000_read_humi_raw(hdc1000_t* p_hdc, uint16_t* p_raw)
 {
-	return (*p_hdc->platform_cb)(p_hdc, msg, arg, NULL);
+	uint16_t word;
+	int result;
+
+	result = hdc1000_begin_call(p_hdc);
+	if (result == HDC1000_OK)
+	{
+		result = hdc1000_read_words(p_hdc, HDC1000_REG_HUMI, &word, 1);
+	}
+	if (result == HDC1000_OK)
+	{
+		*p_raw = hdc1000_filter_raw(p_hdc, HDC1000_FILTER_HUMI, word);
+	}
+	return result;
 }
 
+/// <summary>
+///		Read Relative Humidity
+/// <para>See hdc1000_read_temp_raw().</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_humi">Relative Humidity in %RH output</param>
+/// <returns>HDC1000_OK or negative status</returns>
 ///
-///
-static int 
-hdc1000_gpio(hdc1000_t* p_hdc, uint8_t msg, uint8_t arg_int, void *arg_ptr) 
+int
+hdc1000_read_humi(hdc1000_t* p_hdc, double* p_humi)
 {
-	return (*p_hdc->platform_cb)(p_hdc, msg, arg_int, arg_ptr);
+	uint16_t raw;
+	int result = hdc1000_read_humi_raw(p_hdc, &raw);
+
+	if (result == HDC1000_OK)
+	{
+		*p_humi = hdc1000_humi_from_raw(raw);
+	}
+	return result;
 }
 
+/// <summary>
+///		Read Temperature in hundredths of degree Celsius
+/// <para>See hdc1000_read_temp_raw().</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_temp">Temperature in 0.01 degrees Celsius output</param>
+/// <returns>HDC1000_OK or negative status</returns>
 ///
-///
-int 
-hdc1000_i2c_write(hdc1000_t* p_hdc, uint8_t arg) 
+int
+hdc1000_read_temp_centi(hdc1000_t* p_hdc, int16_t* p_temp)
 {
-	return (*p_hdc->platform_cb)(p_hdc, HDC1000_MSG_I2C_WRITE_BYTE, arg, NULL);
+	uint16_t raw;
+	int result = hdc1000_read_temp_raw(p_hdc, &raw);
+
+	if (result == HDC1000_OK)
+	{
+		*p_temp = hdc1000_temp_centi_from_raw(p_hdc, raw);
+	}
+	return result;
 }
 
+/// <summary>
+///		Read Relative Humidity in hundredths of %RH
+/// <para>See hdc1000_read_temp_raw().</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_humi">Relative Humidity in 0.01 %RH output</param>
+/// <returns>HDC1000_OK or negative status</returns>
 ///
+int
+hdc1000_read_humi_centi(hdc1000_t* p_hdc, uint16_t* p_humi)
+{
+	uint16_t raw;
+	int result = hdc1000_read_humi_raw(p_hdc, &raw);
+
+	if (result == HDC1000_OK)
+	{
+		*p_humi = hdc1000_humi_centi_from_raw(p_hdc, raw);
+	}
+	return result;
+}
+
+/// <summary>
+///		Read Temperature and Humidity registers from a single acquisition
+/// <para>Status returning variant of hdc1000_get_temp_humi_raw(), see
+/// hdc1000_read_temp_raw().</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_temp">Temperature register value output</param>
+/// <param name="p_humi">Humidity register value output</param>
+/// <returns>HDC1000_OK, HDC1000_ERR_MODE if the device is not in
+/// HDC1000_CFG_BOTH_TEMP_HUMI mode or negative status</returns>
 ///
-static int
-hdc1000_i2c_read_bytes(hdc1000_t *p_hdc, uint8_t *buffer, uint8_t length) 
+int
+hdc1000_read_temp_humi_raw(hdc1000_t* p_hdc, uint16_t* p_temp,
+	uint16_t* p_humi)
 {
-	return (*p_hdc->platform_cb)(p_hdc, HDC1000_MSG_I2C_READ_BYTES, length,
-		buffer);
+	uint16_t words[2];
+	int result;
+
+	// Single measurement mode returns no humidity word after temperature
+	if (!(p_hdc->config & HDC1000_CFG_BOTH_TEMP_HUMI))
+	{
+		return HDC1000_ERR_MODE;
+	}
+
+	result = hdc1000_begin_call(p_hdc);
+	if (result == HDC1000_OK)
+	{
+		result = hdc1000_read_words(p_hdc, HDC1000_REG_TEMP, words, 2);
+	}
+	if (result == HDC1000_OK)
+	{
+		*p_temp = hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, words[0]);
+		*p_humi = hdc1000_filter_raw(p_hdc, HDC1000_FILTER_HUMI, words[1]);
+	}
+	return result;
+}
+
+/// <summary>
+///		Read Temperature and Relative Humidity from a single acquisition
+/// <para>See hdc1000_read_temp_humi_raw().</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_temp">Temperature in degrees Celsius output</param>
+/// <param name="p_humi">Relative Humidity in %RH output</param>
+/// <returns>HDC1000_OK or negative status</returns>
+///
+int
+hdc1000_read_temp_humi(hdc1000_t* p_hdc, double* p_temp, double* p_humi)
+{
+	uint16_t temp_raw;
+	uint16_t humi_raw;
+	int result = hdc1000_read_temp_humi_raw(p_hdc, &temp_raw, &humi_raw);
+
+	if (result == HDC1000_OK)
+	{
+		*p_temp = hdc1000_temp_from_raw(temp_raw);
+		*p_humi = hdc1000_humi_from_raw(humi_raw);
+	}
+	return result;
+}
+
+/// <summary>
+///		Trigger a measurement without waiting for its completion
+/// <para>Use hdc1000_poll() to check for completion and hdc1000_fetch()
+/// to read the result. Other bus accesses to the device must not be made
+/// while a measurement is pending.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="reg_addr">HDC1000_REG_TEMP or HDC1000_REG_HUMI</param>
+/// <returns>Time in microseconds until the result is ready, or
+/// HDC1000_ERR_NOT_READY if a measurement is already pending,
+/// HDC1000_ERR_ARG if reg_addr is not a result register, HDC1000_ERR_IO
+/// if the measurement could not be triggered or negative status of the
+/// clock read, split-phase measurements need HDC1000_MSG_GET_TIME_MICRO
+/// </returns>
+///
+int
+hdc1000_start_measurement(hdc1000_t* p_hdc, uint8_t reg_addr)
+{
+	uint32_t conv_time;
+	uint64_t now;
+	int result;
+
+	if (p_hdc->meas_state == HDC1000_STATE_BUSY)
+	{
+		// Pending conversion would be restarted and its result lost
+		return HDC1000_ERR_NOT_READY;
+	}
+
+	if (reg_addr != HDC1000_REG_TEMP && reg_addr != HDC1000_REG_HUMI)
+	{
+		return HDC1000_ERR_ARG;
+	}
+
+	conv_time = hdc1000_get_conversion_time(p_hdc, reg_addr);
+
+	if (hdc1000_i2c_write(p_hdc, reg_addr) < 0)
+	{
+		p_hdc->meas_state = HDC1000_STATE_IDLE;
+		return HDC1000_ERR_IO;
+	}
+
+	// Completion is timed from here, measurement without clock is lost.
+	// Platforms deferring the pointer write send it with this message
+	// and report its failure here
+	result = hdc1000_get_time_us(p_hdc, &now);
+	if (result != HDC1000_OK)
+	{
+		p_hdc->meas_state = HDC1000_STATE_IDLE;
+		return result;
+	}
+
+	p_hdc->meas_reg = reg_addr;
+	p_hdc->meas_ready_us = now + conv_time;
+	p_hdc->meas_deadline_us = now + 
+		(uint64_t)conv_time * HDC1000_DRDYN_TIMEOUT_FACTOR;
+	p_hdc->meas_state = HDC1000_STATE_BUSY;
+
+	return (int)conv_time;
+}
+
+/// <summary>
+///		Check state of a measurement started by hdc1000_start_measurement()
+/// <para>Never blocks. With DRDYn pin configured the pin is sampled once,
+/// otherwise completion is based on the expected conversion time. DRDYn
+/// staying HIGH for HDC1000_DRDYN_TIMEOUT_FACTOR times the conversion
+/// time or a failed pin read abandons the measurement.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_remaining_us">Optional output of time in microseconds
+/// until the result is expected, 0 when ready or idle</param>
+/// <returns>HDC1000_STATE_IDLE, HDC1000_STATE_BUSY,
+/// HDC1000_STATE_READY, or HDC1000_ERR_TIMEOUT, HDC1000_ERR_IO or negative
+/// status of the clock read after which the state is idle</returns>
+///
+int
+hdc1000_poll(hdc1000_t* p_hdc, uint32_t* p_remaining_us)
+{
+	uint8_t drdyn_state = 1;
+	uint64_t now;
+	int result;
+
+	if (p_remaining_us != NULL)
+	{
+		*p_remaining_us = 0;
+	}
+
+	if (p_hdc->meas_state != HDC1000_STATE_BUSY)
+	{
+		return p_hdc->meas_state;
+	}
+
+	result = hdc1000_get_time_us(p_hdc, &now);
+	if (result != HDC1000_OK)
+	{
+		p_hdc->meas_state = HDC1000_STATE_IDLE;
+		return result;
+	}
+
+	if (p_hdc->drdyn_pin > -1)
+	{
+		// After measurement is complete DRDYn is set to LOW
+		if (hdc1000_gpio(p_hdc, HDC1000_MSG_GPIO_GET_VALUE, 0, 
+			&drdyn_state) < 0)
+		{
+			p_hdc->meas_state = HDC1000_STATE_IDLE;
+			return HDC1000_ERR_IO;
+		}
+		if (drdyn_state == 0)
+		{
+			p_hdc->meas_state = HDC1000_STATE_READY;
+		}
+		else if (now >= p_hdc->meas_deadline_us)
+		{
+			p_hdc->meas_state = HDC1000_STATE_IDLE;
+			return HDC1000_ERR_TIMEOUT;
+		}
+	}
+	else if (now >= p_hdc->meas_ready_us)
+	{
+		p_hdc->meas_state = HDC1000_STATE_READY;
+	}
+
+	if (p_hdc->meas_state == HDC1000_STATE_BUSY && p_remaining_us != NULL
+		&& now < p_hdc->meas_ready_us)
+	{
+		*p_remaining_us = (uint32_t)(p_hdc->meas_ready_us - now);
+	}
+
+	return p_hdc->meas_state;
+}
+
+/// <summary>
+///		Read result of a completed measurement
+/// <para>In HDC1000_CFG_BOTH_TEMP_HUMI mode a measurement started on
+/// temperature register returns both values, otherwise only the value
+/// of the measured register is stored.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_temp">Temperature register value output or NULL</param>
+/// <param name="p_humi">Humidity register value output or NULL</param>
+/// <returns>HDC1000_OK, HDC1000_ERR_NOT_READY if no completed
+/// measurement is available or HDC1000_ERR_IO if the read failed</returns>
+///
+int
+hdc1000_fetch(hdc1000_t* p_hdc, uint16_t* p_temp, uint16_t* p_humi)
+{
+	uint8_t bytes[4];
+	uint16_t value;
+
+	if (p_hdc->meas_state != HDC1000_STATE_READY)
+	{
+		return HDC1000_ERR_NOT_READY;
+	}
+
+	p_hdc->meas_state = HDC1000_STATE_IDLE;
+
+	if ((p_hdc->config & HDC1000_CFG_BOTH_TEMP_HUMI) &&
+		p_hdc->meas_reg == HDC1000_REG_TEMP)
+	{
+		if (hdc1000_i2c_read_bytes(p_hdc, bytes, 4) < 0)
+		{
+			return HDC1000_ERR_IO;
+		}
+		if (p_temp != NULL)
+		{
+			*p_temp = (uint16_t)((bytes[0] << 8) + bytes[1]);
+		}
+		if (p_humi != NULL)
+		{
+			*p_humi = (uint16_t)((bytes[2] << 8) + bytes[3]);
+		}
+		return HDC1000_OK;
+	}
+
+	if (hdc1000_i2c_read_bytes(p_hdc, bytes, 2) < 0)
+	{
+		return HDC1000_ERR_IO;
+	}
+
+	value = (uint16_t)((bytes[0] << 8) + bytes[1]);
+	if (p_hdc->meas_reg == HDC1000_REG_TEMP && p_temp != NULL)
+	{
+		*p_temp = value;
+	}
+	else if (p_hdc->meas_reg == HDC1000_REG_HUMI && p_humi != NULL)
+	{
+		*p_humi = value;
+	}
+	return HDC1000_OK;
+}
+
+/// <summary>
+///		Acquire measurements from a group of sensors with overlapping
+///		conversions
+/// <para>Triggers conversions on all sensors first, then reads each result
+/// as soon as it is ready, so total time is about one conversion plus
+/// the bus transfers. Sensors may differ in mode and resolution, the group
+/// is waited for up to HDC1000_DRDYN_TIMEOUT_FACTOR times the longest
+/// conversion time among them. Sleeps between polls use the platform of
+/// the first sensor, all sensors have to share the same time base.</para>
+/// </summary>
+/// <param name="pp_hdc">Array of pointers to hdc1000_t data structs</param>
+/// <param name="count">Number of sensors</param>
+/// <param name="reg_addr">HDC1000_REG_TEMP or HDC1000_REG_HUMI, see
+/// hdc1000_fetch() for values returned in combined mode</param>
+/// <param name="p_temp">Temperature register values output array or NULL
+/// </param>
+/// <param name="p_humi">Humidity register values output array or NULL
+/// </param>
+/// <param name="p_status">Per sensor status output array or NULL,
+/// HDC1000_OK on success, HDC1000_ERR_TIMEOUT if the result was not
+/// ready in time, HDC1000_ERR_IO if the sensor failed. If any sensor has
+/// a measurement pending, no sensor is started and all report
+/// HDC1000_ERR_NOT_READY.</param>
+/// <returns>Number of sensors read successfully</returns>
+///
+int
+hdc1000_read_group(hdc1000_t** pp_hdc, size_t count, uint8_t reg_addr,
+	uint16_t* p_temp, uint16_t* p_humi, int* p_status)
+{
+	int conv_time;
+	uint32_t max_conv_time = 0;
+	uint32_t remaining;
+	uint32_t min_remaining;
+	uint64_t deadline;
+	uint64_t now;
+	size_t pending = count;
+	size_t done = 0;
+	size_t i;
+	int state;
+	int result;
+	int abandon = HDC1000_ERR_TIMEOUT;
+
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	for (i = 0; i < count && pp_hdc[i]->meas_state != HDC1000_STATE_BUSY;
+		i++)
+	{
+	}
+	if (i < count)
+	{
+		// Pending split-phase measurement would be fetched by the group
+		for (i = 0; p_status != NULL && i < count; i++)
+		{
+			p_status[i] = HDC1000_ERR_NOT_READY;
+		}
+		return 0;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		conv_time = hdc1000_start_measurement(pp_hdc[i], reg_addr);
+		if (conv_time > (int)max_conv_time)
+		{
+			max_conv_time = (uint32_t)conv_time;
+		}
+
+		// Sensor which failed to start stays idle and is not waited for
+		result = (conv_time < 0) ? conv_time : HDC1000_ERR_TIMEOUT;
+		if (conv_time < 0)
+		{
+			pending--;
+		}
+		if (p_status != NULL)
+		{
+			p_status[i] = result;
+		}
+	}
+
+	// Longest conversion of the group bounds the wait, not the first one
+	result = hdc1000_get_time_us(pp_hdc[0], &deadline);
+	if (result != HDC1000_OK)
+	{
+		abandon = result;
+		pending = 0;
+	}
+	deadline += (uint64_t)max_conv_time * HDC1000_DRDYN_TIMEOUT_FACTOR;
+
+	while (pending > 0)
+	{
+		min_remaining = max_conv_time;
+
+		for (i = 0; i < count; i++)
+		{
+			// Sensors already read are idle
+			state = hdc1000_poll(pp_hdc[i], &remaining);
+			if (state == HDC1000_STATE_READY)
+			{
+				result = hdc1000_fetch(pp_hdc[i], 
+					(p_temp != NULL) ? &p_temp[i] : NULL,
+					(p_humi != NULL) ? &p_humi[i] : NULL);
+				if (p_status != NULL)
+				{
+					p_status[i] = result;
+				}
+				if (result == HDC1000_OK)
+				{
+					done++;
+				}
+				pending--;
+			}
+			else if (state < 0)
+			{
+				// DRDYn timed out or could not be read
+				if (p_status != NULL)
+				{
+					p_status[i] = state;
+				}
+				pending--;
+			}
+			else if (state == HDC1000_STATE_BUSY && remaining < min_remaining)
+			{
+				min_remaining = remaining;
+			}
+		}
+
+		if (pending == 0)
+		{
+			break;
+		}
+		result = hdc1000_get_time_us(pp_hdc[0], &now);
+		if (result != HDC1000_OK)
+		{
+			abandon = result;
+			break;
+		}
+		if (now >= deadline)
+		{
+			break;
+		}
+
+		// Sleep until the earliest expected completion. Sensors still busy
+		// past their conversion time, waiting for DRDYn, report 0 remaining
+		result = hdc1000_delay_us(pp_hdc[0], (min_remaining > 0) ? 
+			min_remaining : HDC1000_DRDYN_SLEEP_MIN_US);
+		if (result != HDC1000_OK)
+		{
+			abandon = result;
+			break;
+		}
+	}
+
+	// Abandon measurements not finished in time
+	for (i = 0; i < count; i++)
+	{
+		if (pp_hdc[i]->meas_state == HDC1000_STATE_BUSY && p_status != NULL)
+		{
+			p_status[i] = abandon;
+		}
+		pp_hdc[i]->meas_state = HDC1000_STATE_IDLE;
+	}
+
+	return (int)done;
+}
+
+/// <summary>
+///		Read identity registers into identity cache
+/// <para>Called by hdc1000_init(). Cache is marked valid only if
+/// manufacturer ID matches, otherwise identity getters retry reading.
+/// </para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <returns>HDC1000_OK, HDC1000_ERR_DEVICE if manufacturer ID does not
+/// match or negative status if identity registers were not read</returns>
+///
+int
+hdc1000_refresh_identity(hdc1000_t* p_hdc)
+{
+	static const uint8_t regs[5] = { HDC1000_REG_MFID, HDC1000_REG_DEVID,
+		HDC1000_REG_SERID_1, HDC1000_REG_SERID_2, HDC1000_REG_SERID_3 };
+	hdc1000_identity_t* p_id = &p_hdc->identity;
+	uint16_t* values[5] = { &p_id->mf_id, &p_id->dev_id, 
+		&p_id->serid[0], &p_id->serid[1], &p_id->serid[2] };
+	uint8_t bytes[2];
+	int result;
+	int i;
+
+	result = hdc1000_begin_call(p_hdc);
+	for (i = 0; i < 5; i++)
+	{
+		if (result == HDC1000_OK)
+		{
+			result = hdc1000_read_register(p_hdc, regs[i], bytes, 2);
+		}
+		if (result != HDC1000_OK)
+		{
+			p_hdc->identity_valid = 0;
+			return result;
+		}
+		*values[i] = (uint16_t)((bytes[0] << 8) + bytes[1]);
+	}
+
+	// Serial bits [39:24] in 0xFB, [23:8] in 0xFC, [7:0] in 0xFD MSB
+	p_id->serial_id = ((uint64_t)p_id->serid[0] << 24) |
+		((uint64_t)p_id->serid[1] << 8) | (p_id->serid[2] >> 8);
+
+	p_hdc->identity_valid = (p_id->mf_id == HDC1000_MFID_TI);
+	return p_hdc->identity_valid ? HDC1000_OK : HDC1000_ERR_DEVICE;
+}
+
+/// <summary>
+///		Get cached identity registers
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <returns>Pointer to identity cache</returns>
+///
+const hdc1000_identity_t
+*hdc1000_get_identity(hdc1000_t* p_hdc)
+{
+	if (!p_hdc->identity_valid)
+	{
+		hdc1000_refresh_identity(p_hdc);
+	}
+	return &p_hdc->identity;
+}
+
+/// <summary>
+///		Get 40-bit device serial number
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <returns>HDC1000 Serial ID</returns>
+///
+uint64_t
+hdc1000_get_serial_id(hdc1000_t* p_hdc)
+{
+	return hdc1000_get_identity(p_hdc)->serial_id;
+}
+
+/// <summary>
+///		Get manufacturer ID (= 0x5449)
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <returns>HDC1000 Manufacturer ID</returns>
+///
+uint16_t 
+hdc1000_get_mf_id(hdc1000_t* p_hdc) 
+{
+	return hdc1000_get_identity(p_hdc)->mf_id;
+}
+
+///<summary>
+///   Get device ID (= 0x1000)
+///</summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <returns>HDC1000 Device ID</returns>
+///
+uint16_t 
+hdc1000_get_dev_id(hdc1000_t* p_hdc) 
+{
+	return hdc1000_get_identity(p_hdc)->dev_id;
+}
+
+/// <summary>
+///		Get device battery status (BTST)
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <returns>Battery Voltage Status: 0 - over 2.8V, 1 - under 2.8V</returns>
+///
+uint8_t 
+hdc1000_get_battery_status(hdc1000_t* p_hdc) 
+{
+	uint8_t btst = 0;
+
+	hdc1000_read_battery_status(p_hdc, &btst);
+	return btst;
+}
+
+/// <summary>
+///		Read device battery status (BTST)
+/// <para>Status returning variant of hdc1000_get_battery_status().</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_btst">Battery Voltage Status output: 0 - over 2.8V,
+/// 1 - under 2.8V</param>
+/// <returns>HDC1000_OK or negative status</returns>
+///
+int
+hdc1000_read_battery_status(hdc1000_t* p_hdc, uint8_t* p_btst)
+{
+	uint16_t config;
+	uint64_t now;
+	int result;
+
+	// Cache without a clock reading on both ends is stale
+	if (p_hdc->btst_max_age_us > 0 && p_hdc->btst_read_us != UINT64_MAX &&
+		hdc1000_get_time_us(p_hdc, &now) == HDC1000_OK &&
+		now - p_hdc->btst_read_us < p_hdc->btst_max_age_us)
+	{
+		*p_btst = p_hdc->btst;
+		return HDC1000_OK;
+	}
+
+	result = hdc1000_read_config(p_hdc, &config);
+	if (result == HDC1000_OK)
+	{
+		*p_btst = p_hdc->btst;
+	}
+	return result;
+}
+
+/*******************************************************************************
+* Private functions
+*******************************************************************************/
+
+/// <summary>
+///		Get storage for a device from static pool or heap
+/// <para>Pool is not thread safe, init and shutdown devices from one
+/// thread.</para>
+/// </summary>
+/// <returns>Pointer to hdc1000_t with storage set, NULL if exhausted
+/// </returns>
+static hdc1000_t
+*hdc1000_alloc(void)
+{
+	hdc1000_t* p_hdc;
+#if HDC1000_POOL_SIZE > 0
+	size_t i;
+
+	for (i = 0; i < HDC1000_POOL_SIZE; i++)
+	{
+		if (!hdc1000_pool_used[i])
+		{
+			hdc1000_pool_used[i] = 1;
+			p_hdc = &hdc1000_pool[i];
+			p_hdc->storage = HDC1000_STORAGE_POOL;
+			return p_hdc;
+		}
+	}
+	return NULL;
+#else
+	p_hdc = (hdc1000_t*)malloc(sizeof(hdc1000_t));
+	if (p_hdc != NULL)
+	{
+		p_hdc->storage = HDC1000_STORAGE_HEAP;
+	}
+	return p_hdc;
+#endif
+}
+
+/// <summary>
+///		Return device storage to its owner
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+static void
+hdc1000_free(hdc1000_t* p_hdc)
+{
+	switch (p_hdc->storage)
+	{
+#if HDC1000_POOL_SIZE > 0
+	case HDC1000_STORAGE_POOL:
+		hdc1000_pool_used[p_hdc - hdc1000_pool] = 0;
+		break;
+#endif
+	case HDC1000_STORAGE_HEAP:
+		free(p_hdc);
+		break;
+	default:
+		// Caller provided storage
+		break;
+	}
+}
+
+/// <summary>
+///		Set register address for subsequent access
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="reg_addr">Address of register to be accessed</param>
+/// <returns>HDC1000_OK, HDC1000_ERR_IO if write failed,
+/// HDC1000_ERR_TIMEOUT if DRDYn wait timed out or negative status of the
+/// conversion wait</returns>
+static int
+hdc1000_set_reg_addr(hdc1000_t *p_hdc, uint8_t reg_addr) 
+{
+	uint32_t conv_time = hdc1000_get_conversion_time(p_hdc, reg_addr);
+
+	if (hdc1000_i2c_write(p_hdc, reg_addr) < 0)
+	{
+		return HDC1000_ERR_IO;
+	}
+
+	if (conv_time == 0)
+	{
+		// No conversion triggered, register can be read immediately
+		return HDC1000_OK;
+	}
+
+	if (p_hdc->drdyn_pin > -1) 
+    {
+		// Using DRDYn to ack
+		return hdc1000_wait_drdyn(p_hdc, conv_time);
+	}
+
+	return hdc1000_delay_us(p_hdc, conv_time);
+}
+
+/// <summary>
+///		Write configuration register and update its shadow
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="config">Configuration register MSB</param>
+/// <returns>HDC1000_OK or negative status, shadow is kept on failure
+/// </returns>
+static int
+hdc1000_write_config(hdc1000_t* p_hdc, uint8_t config)
+{
+	uint8_t bytes[3] = { HDC1000_REG_CONFIG, config, 0 };
+	uint8_t attempt = 0;
+	int result;
+
+	do
+	{
+		// Register pointer and 16-bit value in one transfer, separate
+		// single byte transfers would not be understood by the device
+		result = hdc1000_i2c_write_bytes(p_hdc, bytes, 3);
+	} while (result < 0 && result != HDC1000_CB_UNSUPPORTED &&
+		hdc1000_retry(p_hdc, &attempt, 0));
+
+	if (result == HDC1000_CB_UNSUPPORTED || result > HDC1000_CB_OK)
+	{
+		return hdc1000_write_config_bytes(p_hdc, config);
+	}
+	if (result < 0)
+	{
+		return HDC1000_ERR_IO;
+	}
+
+	// Reset bit self clears, soft reset restores default configuration
+	p_hdc->config = (config & HDC1000_CFG_RST) ? HDC1000_CFG_DEFAULT :
+		(config & (uint8_t)~HDC1000_CFG_BTST);
+	return HDC1000_OK;
+}
+
+/// <summary>
+///		Write configuration register as single bytes and read it back
+/// <para>Fallback for platforms not acknowledging
+/// HDC1000_MSG_I2C_WRITE_BYTES, sends the bytes the way the original
+/// driver did. Whether they reached the register as one transfer is
+/// known only from the read back value, which becomes the shadow.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="config">Configuration register MSB</param>
+/// <returns>HDC1000_OK, HDC1000_ERR_IO if the register does not hold the
+/// written value or negative status of the read</returns>
+static int
+hdc1000_write_config_bytes(hdc1000_t* p_hdc, uint8_t config)
+{
+	uint8_t bytes[3] = { HDC1000_REG_CONFIG, config, 0 };
+	uint8_t expected;
+	int result;
+	int i;
+
+	for (i = 0; i < 3; i++)
+	{
+		if (hdc1000_i2c_write(p_hdc, bytes[i]) < 0)
+		{
+			return HDC1000_ERR_IO;
+		}
+	}
+
+	result = hdc1000_read_register(p_hdc, HDC1000_REG_CONFIG, bytes, 2);
+	if (result != HDC1000_OK)
+	{
+		return result;
+	}
+
+	expected = (config & HDC1000_CFG_RST) ? HDC1000_CFG_DEFAULT :
+		(config & (uint8_t)~HDC1000_CFG_BTST);
+	p_hdc->config = bytes[0] & (uint8_t)~(HDC1000_CFG_RST | HDC1000_CFG_BTST);
+	return (p_hdc->config == expected) ? HDC1000_OK : HDC1000_ERR_IO;
+}
+
+/// <summary>
+///		Read-modify-write configuration shadow, write register on change
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="mask">Configuration bits to be replaced</param>
+/// <param name="value">New value of masked bits</param>
+/// <returns>1 if configuration was written, 0 if unchanged, negative
+/// status on failure</returns>
+static int
+hdc1000_update_config(hdc1000_t* p_hdc, uint8_t mask, uint8_t value)
+{
+	uint8_t config = (p_hdc->config & (uint8_t)~mask) | (value & mask);
+	int result;
+
+	if (config == p_hdc->config)
+	{
+		return 0;
+	}
+
+	result = hdc1000_begin_call(p_hdc);
+	if (result == HDC1000_OK)
+	{
+		result = hdc1000_write_config(p_hdc, config);
+	}
+	return (result == HDC1000_OK) ? 1 : result;
+}
+
+/// <summary>
+///		DRDYn wait timeout for a conversion, clipped to deadline of the call
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="conv_time">Expected conversion time in microseconds</param>
+/// <param name="p_timeout">Timeout in microseconds output</param>
+/// <returns>HDC1000_OK or negative status of the clock read</returns>
+static int
+hdc1000_drdyn_timeout(hdc1000_t* p_hdc, uint32_t conv_time,
+	uint32_t* p_timeout)
+{
+	uint64_t now;
+	uint64_t remaining;
+	int result;
+
+	*p_timeout = conv_time * HDC1000_DRDYN_TIMEOUT_FACTOR;
+
+	if (p_hdc->deadline_us != UINT64_MAX)
+	{
+		// Do not wait past deadline of the call
+		result = hdc1000_get_time_us(p_hdc, &now);
+		if (result != HDC1000_OK)
+		{
+			return result;
+		}
+		remaining = (now < p_hdc->deadline_us) ? p_hdc->deadline_us - now : 0;
+		if (remaining < *p_timeout)
+		{
+			*p_timeout = (uint32_t)remaining;
+		}
+	}
+
+	return HDC1000_OK;
+}
+
+/// <summary>
+///		Wait for DRDYn falling edge signalling completed measurement
+/// <para>Uses edge-triggered platform wait if available, otherwise falls
+/// back to polling DRDYn state by hdc1000_poll_drdyn().</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="conv_time">Expected conversion time in microseconds</param>
+/// <returns>HDC1000_OK, HDC1000_ERR_TIMEOUT, HDC1000_ERR_IO or negative
+/// status of the clock read</returns>
+static int
+hdc1000_wait_drdyn(hdc1000_t* p_hdc, uint32_t conv_time)
+{
+	uint32_t timeout;
+	int result;
+
+	result = hdc1000_drdyn_timeout(p_hdc, conv_time, &timeout);
+	if (result != HDC1000_OK)
+	{
+		return result;
+	}
+
+	result = hdc1000_gpio(p_hdc, HDC1000_MSG_GPIO_WAIT_FALLING, 0, &timeout);
+	if (result == HDC1000_CB_UNSUPPORTED || result > HDC1000_CB_OK)
+	{
+		return hdc1000_poll_drdyn(p_hdc, conv_time, timeout);
+	}
+	if (result == HDC1000_CB_TIMEOUT)
+	{
+		return HDC1000_ERR_TIMEOUT;
+	}
+	return (result < 0) ? HDC1000_ERR_IO : HDC1000_OK;
+}
+
+/// <summary>
+///		Poll DRDYn state until it goes LOW or timeout expires
+/// <para>Sleeps through most of the expected conversion time, spins on
+/// DRDYn reads for a bounded number of polls and then backs off with
+/// increasing sleep intervals. Platforms without clock get the time
+/// slept counted as elapsed.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="conv_time">Expected conversion time in microseconds</param>
+/// <param name="timeout">Maximum wait time in microseconds</param>
+/// <returns>HDC1000_OK, HDC1000_ERR_TIMEOUT, HDC1000_ERR_IO or negative
+/// status of a delay or clock read</returns>
+static int
+hdc1000_poll_drdyn(hdc1000_t* p_hdc, uint32_t conv_time, uint32_t timeout)
+{
+	uint8_t drdyn_state = 1;
+	uint32_t sleep_us = HDC1000_DRDYN_SLEEP_MIN_US;
+	uint32_t polls = 0;
+	uint64_t start;
+	uint64_t now;
+	uint64_t elapsed;
+	int clock;
+	int result;
+
+	clock = hdc1000_get_time_us(p_hdc, &start);
+	if (clock != HDC1000_OK && clock != HDC1000_ERR_UNSUPPORTED)
+	{
+		return clock;
+	}
+
+	// DRDYn cannot go LOW before conversion is nearly done, but the
+	// timeout may already be clipped to deadline of the call
+	elapsed = conv_time - (conv_time / 4);
+	if (elapsed > timeout)
+	{
+		elapsed = timeout;
+	}
+	result = hdc1000_delay_us(p_hdc, (uint32_t)elapsed);
+	if (result != HDC1000_OK)
+	{
+		return result;
+	}
+
+	for (;;)
+	{
+		// After measurement is complete DRDYn is set to LOW
+		if (hdc1000_gpio(p_hdc, HDC1000_MSG_GPIO_GET_VALUE, 0, 
+			&drdyn_state) < 0)
+		{
+			return HDC1000_ERR_IO;
+		}
+		if (drdyn_state == 0)
+		{
+			return HDC1000_OK;
+		}
+		if (clock == HDC1000_OK)
+		{
+			result = hdc1000_get_time_us(p_hdc, &now);
+			if (result != HDC1000_OK)
+			{
+				return result;
+			}
+			elapsed = now - start;
+		}
+		if (elapsed >= timeout)
+		{
+			return HDC1000_ERR_TIMEOUT;
+		}
+
+		if (++polls > HDC1000_DRDYN_SPIN_POLLS)
+		{
+			result = hdc1000_delay_us(p_hdc, sleep_us);
+			if (result != HDC1000_OK)
+			{
+				return result;
+			}
+			elapsed += sleep_us;
+			if (sleep_us < HDC1000_DRDYN_SLEEP_MAX_US)
+			{
+				sleep_us *= 2;
+			}
+		}
+	}
+}
+
+/// <summary>
+///		Set register address and read register contents
+///	<para>Whole access including conversion wait is retried on failure.
+/// </para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="reg_addr">Address of register to be read</param>
+/// <param name="buffer">Output buffer</param>
+/// <param name="length">Number of bytes to read</param>
+/// <returns>HDC1000_OK or negative status of the last attempt</returns>
+/// 
+static int
+hdc1000_read_register(hdc1000_t* p_hdc, uint8_t reg_addr, uint8_t* buffer,
+	uint8_t length)
+{
+	uint32_t conv_time = hdc1000_get_conversion_time(p_hdc, reg_addr);
+	uint8_t attempt = 0;
+	int result;
+
+	do
+	{
+		result = hdc1000_access_register(p_hdc, reg_addr, conv_time, buffer,
+			length);
+	} while (result != HDC1000_OK && 
+		hdc1000_retry(p_hdc, &attempt, conv_time));
+
+	return result;
+}
+
+/// <summary>
+///		Read result words, averaged over configured oversampling
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="reg_addr">Result register starting the conversion</param>
+/// <param name="words">Output of count register values</param>
+/// <param name="count">1 for single, 2 for combined acquisition</param>
+/// <returns>HDC1000_OK or negative status of the failed conversion
+/// </returns>
+static int
+hdc1000_read_words(hdc1000_t* p_hdc, uint8_t reg_addr, uint16_t* words,
+	uint8_t count)
+{
+	uint8_t n = p_hdc->filter_oversample;
+	uint32_t sums[2] = { 0, 0 };
+	uint8_t bytes[4];
+	uint8_t i;
+	uint8_t j;
+	int result;
+
+	for (i = 0; i < n; i++)
+	{
+		result = hdc1000_read_register(p_hdc, reg_addr, bytes, 2 * count);
+		if (result != HDC1000_OK)
+		{
+			return result;
+		}
+		for (j = 0; j < count; j++)
+		{
+			sums[j] += (uint32_t)((bytes[2 * j] << 8) + bytes[2 * j + 1]);
+		}
+	}
+
+	// Rounded mean, averaging fills the unused low bits of the register
+	for (j = 0; j < count; j++)
+	{
+		words[j] = (uint16_t)((sums[j] + n / 2) / n);
+	}
+	return HDC1000_OK;
+}
+
+/// <summary>
+///		Single attempt of register pointer write, conversion wait and read
+/// <para>Hands the whole access to the platform as one
+/// HDC1000_MSG_TRANSACTION if the platform declared support. Only
+/// HDC1000_CB_OK completes it. A refused transaction with DRDYn wait is
+/// done in single steps for this access only, other refused transactions
+/// are remembered and not offered again.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="reg_addr">Address of register to be read</param>
+/// <param name="conv_time">Conversion time triggered by the pointer write,
+/// 0 if none</param>
+/// <param name="buffer">Output buffer</param>
+/// <param name="length">Number of bytes to read</param>
+/// <returns>HDC1000_OK, HDC1000_ERR_TIMEOUT or HDC1000_ERR_IO</returns>
+static int
+hdc1000_access_register(hdc1000_t* p_hdc, uint8_t reg_addr,
+	uint32_t conv_time, uint8_t* buffer, uint8_t length)
+{
+	hdc1000_segment_t segs[3];
+	uint8_t count = 0;
+	uint8_t wait = 0;
+	int result;
+
+	if (p_hdc->transaction)
+	{
+		segs[count].type = HDC1000_SEG_WRITE;
+		segs[count].length = 1;
+		segs[count].data = &reg_addr;
+		segs[count].usec = 0;
+		count++;
+
+		if (conv_time > 0)
+		{
+			if (p_hdc->drdyn_pin > -1)
+			{
+				segs[count].type = HDC1000_SEG_WAIT_DRDYN;
+				result = hdc1000_drdyn_timeout(p_hdc, conv_time,
+					&segs[count].usec);
+				if (result != HDC1000_OK)
+				{
+					return result;
+				}
+				wait = 1;
+			}
+			else
+			{
+				segs[count].type = HDC1000_SEG_DELAY;
+				segs[count].usec = conv_time;
+			}
+			segs[count].length = 0;
+			segs[count].data = NULL;
+			count++;
+		}
+
+		segs[count].type = HDC1000_SEG_READ;
+		segs[count].length = length;
+		segs[count].data = buffer;
+		segs[count].usec = 0;
+		count++;
+
+		result = PLATFORM_CALL(p_hdc, HDC1000_MSG_TRANSACTION, count, segs);
+		if (result == HDC1000_CB_OK)
+		{
+			return HDC1000_OK;
+		}
+		if (result == HDC1000_CB_TIMEOUT)
+		{
+			return HDC1000_ERR_TIMEOUT;
+		}
+		if (result < 0 && result != HDC1000_CB_UNSUPPORTED)
+		{
+			return HDC1000_ERR_IO;
+		}
+
+		// Platform may lack only DRDYn edge events, keep transactions for
+		// accesses without wait. Otherwise one message per step from now on
+		if (!wait)
+		{
+			p_hdc->transaction = 0;
+		}
+	}
+
+	result = hdc1000_set_reg_addr(p_hdc, reg_addr);
+	if (result == HDC1000_OK && 
+		hdc1000_i2c_read_bytes(p_hdc, buffer, length) < 0)
+	{
+		result = HDC1000_ERR_IO;
+	}
+	return result;
+}
+
+/// <summary>
+///		Start time budget of a public call
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <returns>HDC1000_OK or negative status of the clock read, a budget
+/// cannot be kept without clock</returns>
+static int
+hdc1000_begin_call(hdc1000_t* p_hdc)
+{
+	uint64_t now;
+	int result;
+
+	// Unlimited budget costs no time queries
+	p_hdc->deadline_us = UINT64_MAX;
+	if (p_hdc->timeout_us == 0)
+	{
+		return HDC1000_OK;
+	}
+
+	result = hdc1000_get_time_us(p_hdc, &now);
+	if (result == HDC1000_OK)
+	{
+		p_hdc->deadline_us = now + p_hdc->timeout_us;
+	}
+	return result;
+}
+
+/// <summary>
+///		Decide on retry of a failed access and prepare the bus for it
+/// <para>Gives up when retries are exhausted or when backoff and the
+/// retried access would not fit before deadline of the call. Otherwise
+/// asks the platform for bus recovery and sleeps for the backoff.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_attempt">Number of retries made so far, incremented
+/// </param>
+/// <param name="attempt_us">Expected duration of the retried access</param>
+/// <returns>1 to retry, 0 to give up</returns>
+static int
+hdc1000_retry(hdc1000_t* p_hdc, uint8_t* p_attempt, uint32_t attempt_us)
+{
+	uint32_t backoff = p_hdc->retry_backoff_us;
+	uint64_t now;
+	uint8_t i;
+
+	if (*p_attempt >= p_hdc->retries)
+	{
+		return 0;
+	}
+
+	for (i = 0; i < *p_attempt && backoff <= HDC1000_RETRY_BACKOFF_MAX_US / 2;
+		i++)
+	{
+		backoff *= 2;
+	}
+
+	if (p_hdc->deadline_us != UINT64_MAX && 
+		(hdc1000_get_time_us(p_hdc, &now) != HDC1000_OK ||
+		now + backoff + attempt_us > p_hdc->deadline_us))
+	{
+		return 0;
+	}
+
+	(*p_attempt)++;
+
+	// Platforms without bus recovery return HDC1000_CB_UNSUPPORTED
+	hdc1000_i2c_recover(p_hdc);
+	if (backoff > 0 && hdc1000_delay_us(p_hdc, backoff) != HDC1000_OK)
+	{
+		return 0;
+	}
+	return 1;
+}
+
+/// <summary>
+///		Convert Temperature register value to degrees Celsius
+/// </summary>
+/// <param name="raw">Temperature register value</param>
+/// <returns>Temperature in degrees Celsius</returns>
+///
+static double
+hdc1000_temp_from_raw(uint16_t raw)
+{
+	return (((double)raw / 65536.0) * 165.0) - 40.0;
+}
+
+/// <summary>
+///		Convert Humidity register value to %RH
+/// </summary>
+/// <param name="raw">Humidity register value</param>
+/// <returns>Relative Humidity in %RH</returns>
+///
+static double
+hdc1000_humi_from_raw(uint16_t raw)
+{
+	return ((double)raw / 65536.0) * 100.0;
+}
+
+/// <summary>
+///		Convert Temperature register value to hundredths by resolution
+/// <para>In 11-bit resolution register values with the unused low bits
+/// clear are looked up in hdc1000_lut_temp_11bit, which holds the result
+/// of hdc1000_temp_raw_to_centi() for them. Filtered values may have low
+/// bits set and are converted arithmetically.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="raw">Temperature register value</param>
+/// <returns>Temperature in 0.01 degrees Celsius</returns>
+///
+static int16_t
+hdc1000_temp_centi_from_raw(hdc1000_t* p_hdc, uint16_t raw)
+{
+	if ((p_hdc->config & HDC1000_CFG_TEMP_11BIT) &&
+		(raw & ((1u << HDC1000_LUT_SHIFT_11BIT) - 1)) == 0)
+	{
+		return hdc1000_lut_temp_11bit[raw >> HDC1000_LUT_SHIFT_11BIT];
+	}
+	return hdc1000_temp_raw_to_centi(raw);
+}
+
+/// <summary>
+///		Convert Humidity register value to hundredths by resolution
+/// <para>In 11-bit and 8-bit resolution register values with the unused
+/// low bits clear are looked up in hdc1000_lut_humi_11bit or
+/// hdc1000_lut_humi_8bit, see hdc1000_temp_centi_from_raw().</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="raw">Humidity register value</param>
+/// <returns>Relative Humidity in 0.01 %RH</returns>
+///
+static uint16_t
+hdc1000_humi_centi_from_raw(hdc1000_t* p_hdc, uint16_t raw)
+{
+	switch (p_hdc->config & HDC1000_CFG_HUMI_RES_MASK)
+	{
+	case HDC1000_CFG_HUMI_11BIT:
+		if ((raw & ((1u << HDC1000_LUT_SHIFT_11BIT) - 1)) == 0)
+		{
+			return hdc1000_lut_humi_11bit[raw >> HDC1000_LUT_SHIFT_11BIT];
+		}
+		break;
+
+	case HDC1000_CFG_HUMI_8BIT:
+		if ((raw & ((1u << HDC1000_LUT_SHIFT_8BIT) - 1)) == 0)
+		{
+			return hdc1000_lut_humi_8bit[raw >> HDC1000_LUT_SHIFT_8BIT];
+		}
+		break;
+	}
+	return hdc1000_humi_raw_to_centi(raw);
+}
+
+/// <summary>
+///		Sleep for microseconds
+/// <para>Platforms not acknowledging HDC1000_MSG_DELAY_MICRO sleep in
+/// whole milliseconds, rounded up.</para>
+/// </summary>
+/// <returns>HDC1000_OK or HDC1000_ERR_IO</returns>
+static int 
+hdc1000_delay_us(hdc1000_t* p_hdc, uint32_t usec) 
+{
+	uint32_t msec;
+	uint8_t chunk;
+	int result;
+
+	result = PLATFORM_CALL(p_hdc, HDC1000_MSG_DELAY_MICRO, 0, &usec);
+	if (result == HDC1000_CB_OK)
+	{
+		return HDC1000_OK;
+	}
+	if (result < 0 && result != HDC1000_CB_UNSUPPORTED)
+	{
+		return HDC1000_ERR_IO;
+	}
+
+	// Milliseconds are passed in arg_int, longer delays take several calls
+	msec = usec / 1000 + ((usec % 1000) ? 1 : 0);
+	while (msec > 0)
+	{
+		chunk = (msec > UINT8_MAX) ? UINT8_MAX : (uint8_t)msec;
+		if (PLATFORM_CALL(p_hdc, HDC1000_MSG_DELAY_MILLI, chunk, NULL) < 0)
+		{
+			return HDC1000_ERR_IO;
+		}
+		msec -= chunk;
+	}
+	return HDC1000_OK;
+}
+
+/// <summary>
+///		Read monotonic platform clock
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="p_now">Time in microseconds output</param>
+/// <returns>HDC1000_OK, HDC1000_ERR_UNSUPPORTED if the platform has no
+/// clock or HDC1000_ERR_IO</returns>
+static int
+hdc1000_get_time_us(hdc1000_t* p_hdc, uint64_t* p_now)
+{
+	int result = PLATFORM_CALL(p_hdc, HDC1000_MSG_GET_TIME_MICRO, 0, p_now);
+
+	if (result == HDC1000_CB_OK)
+	{
+		return HDC1000_OK;
+	}
+	return (result < 0 && result != HDC1000_CB_UNSUPPORTED) ?
+		HDC1000_ERR_IO : HDC1000_ERR_UNSUPPORTED;
+}
+
+///
+///
+static int 
+hdc1000_gpio(hdc1000_t* p_hdc, uint8_t msg, uint8_t arg_int, void *arg_ptr) 
+{
+	return PLATFORM_CALL(p_hdc, msg, arg_int, arg_ptr);
+}
+
+///
+///
+static int 
+hdc1000_i2c_write(hdc1000_t* p_hdc, uint8_t arg) 
+{
+	return PLATFORM_CALL(p_hdc, HDC1000_MSG_I2C_WRITE_BYTE, arg, NULL);
+}
+
+///
+///
+static int
+hdc1000_i2c_write_bytes(hdc1000_t *p_hdc, uint8_t *buffer, uint8_t length) 
+{
+	return PLATFORM_CALL(p_hdc, HDC1000_MSG_I2C_WRITE_BYTES, length,
+		buffer);
+}
+
+///
+///
+static int
+hdc1000_i2c_read_bytes(hdc1000_t *p_hdc, uint8_t *buffer, uint8_t length) 
+{
+	return PLATFORM_CALL(p_hdc, HDC1000_MSG_I2C_READ_BYTES, length,
+		buffer);
+}
+
+///
+///
+static int
+hdc1000_i2c_recover(hdc1000_t* p_hdc)
+{
+	return PLATFORM_CALL(p_hdc, HDC1000_MSG_I2C_RECOVER, 0, NULL);
 }
 
 /* [] END OF FILE */
@@ -0,0 +1,324 @@
+/***************************************************************************//**
+* @file    hdc1000_batch.c
+* @version 1.0.0
+*
+* @brief Bulk conversion of HDC1000 register values.
+*
+* @par Description
+*    Vector kernels are selected at compile time: AVX2 when built with
+*    -mavx2, SSE2 on x86, NEON on ARM (double precision only on AArch64),
+*    scalar code otherwise. Every kernel produces results identical to the
+*    scalar conversions in hdc1000.c.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HDC1000_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HDC1000_BATCH_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HDC1000_BATCH_NEON
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+// Physical value = raw * SCALE / 65536 + OFFSET
+#define TEMP_SCALE		165
+#define TEMP_OFFSET		-40
+#define HUMI_SCALE		100
+#define HUMI_OFFSET		0
+
+/*******************************************************************************
+* Forward declarations of private functions
+*******************************************************************************/
+
+static void
+hdc1000_batch_centi(const uint16_t* p_raw, uint16_t* p_out, size_t count,
+	uint16_t scale, int16_t offset);
+
+static void
+hdc1000_batch_float(const uint16_t* p_raw, float* p_out, size_t count,
+	float scale, float offset);
+
+static void
+hdc1000_batch_double(const uint16_t* p_raw, double* p_out, size_t count,
+	double scale, double offset);
+
+/*******************************************************************************
+* Public functions
+*******************************************************************************/
+
+/// <summary>
+///		Convert arrays of Temperature and Humidity register values
+/// <para>Output element type depends on format: HDC1000_FMT_FLOAT - float,
+/// HDC1000_FMT_DOUBLE - double, HDC1000_FMT_CENTI - int16_t temperature
+/// and uint16_t humidity in hundredths as hdc1000_temp_raw_to_centi() and
+/// hdc1000_humi_raw_to_centi().</para>
+/// </summary>
+/// <param name="p_temp_raw">Temperature register values or NULL</param>
+/// <param name="p_humi_raw">Humidity register values or NULL</param>
+/// <param name="count">Number of elements in each array</param>
+/// <param name="format">HDC1000_FMT_* output format</param>
+/// <param name="p_temp_out">Temperature output array or NULL</param>
+/// <param name="p_humi_out">Humidity output array or NULL</param>
+/// <returns>0 on success, -1 on unknown format</returns>
+///
+int
+hdc1000_convert_batch(const uint16_t* p_temp_raw, const uint16_t* p_humi_raw,
+	size_t count, uint8_t format, void* p_temp_out, void* p_humi_out)
+{
+	int convert_temp = (p_temp_raw != NULL && p_temp_out != NULL);
+	int convert_humi = (p_humi_raw != NULL && p_humi_out != NULL);
+
+	switch (format)
+	{
+	case HDC1000_FMT_FLOAT:
+		if (convert_temp)
+		{
+			hdc1000_batch_float(p_temp_raw, (float*)p_temp_out, count,
+				TEMP_SCALE, TEMP_OFFSET);
+		}
+		if (convert_humi)
+		{
+			hdc1000_batch_float(p_humi_raw, (float*)p_humi_out, count,
+				HUMI_SCALE, HUMI_OFFSET);
+		}
+		return 0;
+
+	case HDC1000_FMT_DOUBLE:
+		if (convert_temp)
+		{
+			hdc1000_batch_double(p_temp_raw, (double*)p_temp_out, count,
+				TEMP_SCALE, TEMP_OFFSET);
+		}
+		if (convert_humi)
+		{
+			hdc1000_batch_double(p_humi_raw, (double*)p_humi_out, count,
+				HUMI_SCALE, HUMI_OFFSET);
+		}
+		return 0;
+
+	case HDC1000_FMT_CENTI:
+		// Signed temperature is stored as two's complement bit pattern
+		if (convert_temp)
+		{
+			hdc1000_batch_centi(p_temp_raw, (uint16_t*)p_temp_out, count,
+				TEMP_SCALE * 100, TEMP_OFFSET * 100);
+		}
+		if (convert_humi)
+		{
+			hdc1000_batch_centi(p_humi_raw, (uint16_t*)p_humi_out, count,
+				HUMI_SCALE * 100, HUMI_OFFSET * 100);
+		}
+		return 0;
+
+	default:
+		return -1;
+	}
+}
+
+/*******************************************************************************
+* Private functions
+*******************************************************************************/
+
+/// <summary>
+///		out = ((raw * scale + 32768) >> 16) + offset, modulo 2^16
+/// <para>Vector kernels split the 32-bit product into 16-bit halves:
+/// the rounded result is high half plus the top bit of low half.</para>
+/// </summary>
+static void
+hdc1000_batch_centi(const uint16_t* p_raw, uint16_t* p_out, size_t count,
+	uint16_t scale, int16_t offset)
+{
+	size_t i = 0;
+
+#if defined(HDC1000_BATCH_AVX2)
+	const size_t vec_end = count - (count % 16);
+	const __m256i v_scale = _mm256_set1_epi16((short)scale);
+	const __m256i v_offset = _mm256_set1_epi16(offset);
+
+	for (; i < vec_end; i += 16)
+	{
+		__m256i raw = _mm256_loadu_si256((const __m256i*)(p_raw + i));
+		__m256i hi = _mm256_mulhi_epu16(raw, v_scale);
+		__m256i lo = _mm256_mullo_epi16(raw, v_scale);
+		__m256i res = _mm256_add_epi16(hi, _mm256_srli_epi16(lo, 15));
+		_mm256_storeu_si256((__m256i*)(p_out + i), 
+			_mm256_add_epi16(res, v_offset));
+	}
+#elif defined(HDC1000_BATCH_SSE2)
+	const size_t vec_end = count - (count % 8);
+	const __m128i v_scale = _mm_set1_epi16((short)scale);
+	const __m128i v_offset = _mm_set1_epi16(offset);
+
+	for (; i < vec_end; i += 8)
+	{
+		__m128i raw = _mm_loadu_si128((const __m128i*)(p_raw + i));
+		__m128i hi = _mm_mulhi_epu16(raw, v_scale);
+		__m128i lo = _mm_mullo_epi16(raw, v_scale);
+		__m128i res = _mm_add_epi16(hi, _mm_srli_epi16(lo, 15));
+		_mm_storeu_si128((__m128i*)(p_out + i), _mm_add_epi16(res, v_offset));
+	}
+#elif defined(HDC1000_BATCH_NEON)
+	const size_t vec_end = count - (count % 8);
+	const uint16x4_t v_scale = vdup_n_u16(scale);
+	const uint16x8_t v_offset = vdupq_n_u16((uint16_t)offset);
+
+	for (; i < vec_end; i += 8)
+	{
+		uint16x8_t raw = vld1q_u16(p_raw + i);
+		uint32x4_t prod_lo = vmull_u16(vget_low_u16(raw), v_scale);
+		uint32x4_t prod_hi = vmull_u16(vget_high_u16(raw), v_scale);
+		// Rounding narrowing shift adds 1 << 15 before shifting
+		uint16x8_t res = vcombine_u16(vrshrn_n_u32(prod_lo, 16),
+			vrshrn_n_u32(prod_hi, 16));
+		vst1q_u16(p_out + i, vaddq_u16(res, v_offset));
+	}
+#endif
+
+	// Vector loops stop at a multiple of their width, tail is shorter
+	for (; i < count; i++)
+	{
+		p_out[i] = (uint16_t)((((uint32_t)p_raw[i] * scale + 32768u) >> 16)
+			+ (uint16_t)offset);
+	}
+}
+
+/// <summary>
+///		out = raw * scale / 65536 + offset in single precision
+/// <para>raw * scale and the power of two division are exact in float, so
+/// only the final addition rounds and results equal the double conversion
+/// rounded to float.</para>
+/// </summary>
+static void
+hdc1000_batch_float(const uint16_t* p_raw, float* p_out, size_t count,
+	float scale, float offset)
+{
+	const float inv_65536 = 1.0f / 65536.0f;
+	size_t i = 0;
+
+#if defined(HDC1000_BATCH_AVX2)
+	const size_t vec_end = count - (count % 8);
+	const __m256 v_scale = _mm256_set1_ps(scale * inv_65536);
+	const __m256 v_offset = _mm256_set1_ps(offset);
+
+	for (; i < vec_end; i += 8)
+	{
+		__m128i raw = _mm_loadu_si128((const __m128i*)(p_raw + i));
+		__m256 val = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(raw));
+		_mm256_storeu_ps(p_out + i, 
+			_mm256_add_ps(_mm256_mul_ps(val, v_scale), v_offset));
+	}
+#elif defined(HDC1000_BATCH_SSE2)
+	const size_t vec_end = count - (count % 8);
+	const __m128 v_scale = _mm_set1_ps(scale * inv_65536);
+	const __m128 v_offset = _mm_set1_ps(offset);
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i < vec_end; i += 8)
+	{
+		__m128i raw = _mm_loadu_si128((const __m128i*)(p_raw + i));
+		__m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(raw, zero));
+		__m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(raw, zero));
+		_mm_storeu_ps(p_out + i, 
+			_mm_add_ps(_mm_mul_ps(lo, v_scale), v_offset));
+		_mm_storeu_ps(p_out + i + 4, 
+			_mm_add_ps(_mm_mul_ps(hi, v_scale), v_offset));
+	}
+#elif defined(HDC1000_BATCH_NEON)
+	const size_t vec_end = count - (count % 8);
+	const float32x4_t v_scale = vdupq_n_f32(scale * inv_65536);
+	const float32x4_t v_offset = vdupq_n_f32(offset);
+
+	for (; i < vec_end; i += 8)
+	{
+		uint16x8_t raw = vld1q_u16(p_raw + i);
+		float32x4_t lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(raw)));
+		float32x4_t hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(raw)));
+		vst1q_f32(p_out + i, vaddq_f32(vmulq_f32(lo, v_scale), v_offset));
+		vst1q_f32(p_out + i + 4, 
+			vaddq_f32(vmulq_f32(hi, v_scale), v_offset));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		p_out[i] = (float)p_raw[i] * (scale * inv_65536) + offset;
+	}
+}
+
+/// <summary>
+///		out = raw * scale / 65536 + offset in double precision
+/// </summary>
+static void
+hdc1000_batch_double(const uint16_t* p_raw, double* p_out, size_t count,
+	double scale, double offset)
+{
+	size_t i = 0;
+
+#if defined(HDC1000_BATCH_AVX2)
+	const size_t vec_end = count - (count % 8);
+	const __m256d v_scale = _mm256_set1_pd(scale / 65536.0);
+	const __m256d v_offset = _mm256_set1_pd(offset);
+
+	for (; i < vec_end; i += 8)
+	{
+		__m128i raw = _mm_loadu_si128((const __m128i*)(p_raw + i));
+		__m256i val = _mm256_cvtepu16_epi32(raw);
+		__m256d lo = _mm256_cvtepi32_pd(_mm256_castsi256_si128(val));
+		__m256d hi = _mm256_cvtepi32_pd(_mm256_extracti128_si256(val, 1));
+		_mm256_storeu_pd(p_out + i, 
+			_mm256_add_pd(_mm256_mul_pd(lo, v_scale), v_offset));
+		_mm256_storeu_pd(p_out + i + 4, 
+			_mm256_add_pd(_mm256_mul_pd(hi, v_scale), v_offset));
+	}
+#elif defined(HDC1000_BATCH_SSE2)
+	const size_t vec_end = count - (count % 4);
+	const __m128d v_scale = _mm_set1_pd(scale / 65536.0);
+	const __m128d v_offset = _mm_set1_pd(offset);
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i < vec_end; i += 4)
+	{
+		__m128i raw = _mm_loadl_epi64((const __m128i*)(p_raw + i));
+		__m128i val = _mm_unpacklo_epi16(raw, zero);
+		__m128d lo = _mm_cvtepi32_pd(val);
+		__m128d hi = _mm_cvtepi32_pd(_mm_srli_si128(val, 8));
+		_mm_storeu_pd(p_out + i, 
+			_mm_add_pd(_mm_mul_pd(lo, v_scale), v_offset));
+		_mm_storeu_pd(p_out + i + 2, 
+			_mm_add_pd(_mm_mul_pd(hi, v_scale), v_offset));
+	}
+#elif defined(HDC1000_BATCH_NEON) && defined(__aarch64__)
+	const size_t vec_end = count - (count % 4);
+	const float64x2_t v_scale = vdupq_n_f64(scale / 65536.0);
+	const float64x2_t v_offset = vdupq_n_f64(offset);
+
+	for (; i < vec_end; i += 4)
+	{
+		uint32x4_t val = vmovl_u16(vld1_u16(p_raw + i));
+		float64x2_t lo = vcvtq_f64_u64(vmovl_u32(vget_low_u32(val)));
+		float64x2_t hi = vcvtq_f64_u64(vmovl_u32(vget_high_u32(val)));
+		vst1q_f64(p_out + i, vaddq_f64(vmulq_f64(lo, v_scale), v_offset));
+		vst1q_f64(p_out + i + 2, 
+			vaddq_f64(vmulq_f64(hi, v_scale), v_offset));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		p_out[i] = (double)p_raw[i] * (scale / 65536.0) + offset;
+	}
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,192 @@
+/***************************************************************************//**
+* @file    hdc1000_filter.c
+* @version 1.0.0
+*
+* @brief Streaming filter of HDC1000 register values.
+*
+* @par Description
+*    Per-device pipeline of oversampling, running median and exponential
+*    moving average. Oversampling is done by the blocking reads in
+*    hdc1000.c, which pass the averaged word through hdc1000_filter_raw().
+*    State is kept in hdc1000_t, every update takes bounded time.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000.h"
+
+/*******************************************************************************
+* Forward declarations of private functions
+*******************************************************************************/
+
+static uint16_t
+hdc1000_filter_median(hdc1000_filter_state_t* p_state, uint8_t length,
+	uint16_t raw);
+
+static uint16_t
+hdc1000_filter_ema(hdc1000_filter_state_t* p_state, uint8_t shift,
+	uint16_t raw);
+
+/*******************************************************************************
+* Public functions
+*******************************************************************************/
+
+/// <summary>
+///		Configure filter pipeline of blocking reads
+/// <para>Each read averages oversample conversions into one register
+/// value, which then passes a running median of the last median values
+/// and an exponential moving average with weight 2^-ema_shift. Stages
+/// apply to temperature and humidity separately, state is reset.</para>
+/// <para>Oversampling multiplies conversion time of every read.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="oversample">Conversions per read, 0 or 1 for none</param>
+/// <param name="median">Median window length, 0 or 1 for none, limited
+/// to HDC1000_FILTER_MEDIAN_MAX</param>
+/// <param name="ema_shift">EMA weight exponent 0 to 15, 0 for none</param>
+void
+hdc1000_set_filter(hdc1000_t* p_hdc, uint8_t oversample, uint8_t median,
+	uint8_t ema_shift)
+{
+	p_hdc->filter_oversample = (oversample > 0) ? oversample : 1;
+	p_hdc->filter_median = (median > 0) ? median : 1;
+	if (p_hdc->filter_median > HDC1000_FILTER_MEDIAN_MAX)
+	{
+		p_hdc->filter_median = HDC1000_FILTER_MEDIAN_MAX;
+	}
+	p_hdc->filter_ema_shift = (ema_shift < 16) ? ema_shift : 15;
+
+	hdc1000_reset_filter(p_hdc);
+}
+
+/// <summary>
+///		Forget filter history, next value starts the filters anew
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+void
+hdc1000_reset_filter(hdc1000_t* p_hdc)
+{
+	uint8_t i;
+
+	for (i = 0; i < 2; i++)
+	{
+		p_hdc->filter[i].window_pos = 0;
+		p_hdc->filter[i].window_fill = 0;
+		p_hdc->filter[i].ema_valid = 0;
+		p_hdc->filter[i].ema = 0;
+	}
+}
+
+/// <summary>
+///		Keep values out of the filters while the sensor cools down
+/// <para>The heater bit only covers the heated conversions themselves,
+/// values read after it is switched off are still biased.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="hold">1 to pass values through unrecorded, 0 to filter
+/// </param>
+void
+hdc1000_hold_filter(hdc1000_t* p_hdc, uint8_t hold)
+{
+	p_hdc->filter_hold = hold ? 1 : 0;
+}
+
+/// <summary>
+///		Pass register value through median and EMA stages
+/// <para>Called by blocking reads, split-phase users may feed values
+/// from hdc1000_fetch(). Values are returned unchanged and not recorded
+/// while the heater is on or the filters are held, heated conversions
+/// would bias the filters.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="channel">HDC1000_FILTER_TEMP or HDC1000_FILTER_HUMI</param>
+/// <param name="raw">Register value</param>
+/// <returns>Filtered register value</returns>
+uint16_t
+hdc1000_filter_raw(hdc1000_t* p_hdc, uint8_t channel, uint16_t raw)
+{
+	hdc1000_filter_state_t* p_state = &p_hdc->filter[channel & 1];
+
+	if ((p_hdc->config & HDC1000_CFG_HEAT_MASK) || p_hdc->filter_hold)
+	{
+		return raw;
+	}
+
+	if (p_hdc->filter_median > 1)
+	{
+		raw = hdc1000_filter_median(p_state, p_hdc->filter_median, raw);
+	}
+	if (p_hdc->filter_ema_shift > 0)
+	{
+		raw = hdc1000_filter_ema(p_state, p_hdc->filter_ema_shift, raw);
+	}
+	return raw;
+}
+
+/*******************************************************************************
+* Private functions
+*******************************************************************************/
+
+/// <summary>
+///		Add value to median window and return median of the window
+/// <para>Until the window fills up the median of the values seen so far
+/// is returned, lower middle value for even counts.</para>
+/// </summary>
+static uint16_t
+hdc1000_filter_median(hdc1000_filter_state_t* p_state, uint8_t length,
+	uint16_t raw)
+{
+	uint16_t sorted[HDC1000_FILTER_MEDIAN_MAX];
+	uint16_t value;
+	uint8_t i;
+	uint8_t j;
+
+	p_state->window[p_state->window_pos] = raw;
+	p_state->window_pos = (uint8_t)((p_state->window_pos + 1) % length);
+	if (p_state->window_fill < length)
+	{
+		p_state->window_fill++;
+	}
+
+	// Insertion sort of at most HDC1000_FILTER_MEDIAN_MAX values
+	for (i = 0; i < p_state->window_fill; i++)
+	{
+		value = p_state->window[i];
+		for (j = i; j > 0 && sorted[j - 1] > value; j--)
+		{
+			sorted[j] = sorted[j - 1];
+		}
+		sorted[j] = value;
+	}
+
+	return sorted[(p_state->window_fill - 1) / 2];
+}
+
+/// <summary>
+///		Update exponential moving average and return it rounded
+/// </summary>
+static uint16_t
+hdc1000_filter_ema(hdc1000_filter_state_t* p_state, uint8_t shift,
+	uint16_t raw)
+{
+	int64_t diff;
+	uint64_t rounded;
+
+	if (!p_state->ema_valid)
+	{
+		// First value initializes the average
+		p_state->ema = (uint32_t)raw << 16;
+		p_state->ema_valid = 1;
+		return raw;
+	}
+
+	diff = ((int64_t)raw << 16) - (int64_t)p_state->ema;
+	p_state->ema = (uint32_t)((int64_t)p_state->ema + (diff >> shift));
+
+	rounded = ((uint64_t)p_state->ema + 0x8000) >> 16;
+	return (rounded > 0xFFFF) ? 0xFFFF : (uint16_t)rounded;
+}
+
+/* [] END OF FILE */
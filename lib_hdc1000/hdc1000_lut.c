@@ -0,0 +1,144 @@
+/***************************************************************************//**
+* @file    hdc1000_lut.c
+* @version 1.0.0
+*
+* @brief Lookup tables for low resolution HDC1000 register values.
+*
+* @par Description
+*    In 11-bit and 8-bit modes only 2048 or 256 distinct codes carry
+*    information, the register still returns 14 bits. Tables map each code
+*    to hundredths of degC or %RH, so conversion is one shift and one
+*    load. Tables are generated by the preprocessor at build time from
+*    the same integer formulas as hdc1000_temp_raw_to_centi() and
+*    hdc1000_humi_raw_to_centi().
+*
+*    Each code is converted at its register value with the unused low bits
+*    clear, as the device returns it, so results equal the arithmetic
+*    conversion exactly. Values with low bits set, e.g. from filtering,
+*    are truncated to their code.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+// Register value of a code, unused low bits clear
+#define LUT_RAW(code, shift)	((uint32_t)(code) << (shift))
+
+// Same arithmetic as hdc1000_temp_raw_to_centi(), hdc1000_humi_raw_to_centi()
+#define TEMP_CENTI(raw) \
+	((int16_t)((int32_t)(((raw) * 16500u + 32768u) >> 16) - 4000))
+#define HUMI_CENTI(raw) \
+	((uint16_t)(((raw) * 10000u + 32768u) >> 16))
+
+#define TEMP_11BIT(code)	TEMP_CENTI(LUT_RAW(code, HDC1000_LUT_SHIFT_11BIT))
+#define HUMI_11BIT(code)	HUMI_CENTI(LUT_RAW(code, HDC1000_LUT_SHIFT_11BIT))
+#define HUMI_8BIT(code)		HUMI_CENTI(LUT_RAW(code, HDC1000_LUT_SHIFT_8BIT))
+
+// LUT_n(F, i) expands to F(i), F(i + 1), ... F(i + n - 1),
+#define LUT_1(F, i)			F(i),
+#define LUT_2(F, i)			LUT_1(F, i) LUT_1(F, (i) + 1)
+#define LUT_4(F, i)			LUT_2(F, i) LUT_2(F, (i) + 2)
+#define LUT_8(F, i)			LUT_4(F, i) LUT_4(F, (i) + 4)
+#define LUT_16(F, i)		LUT_8(F, i) LUT_8(F, (i) + 8)
+#define LUT_32(F, i)		LUT_16(F, i) LUT_16(F, (i) + 16)
+#define LUT_64(F, i)		LUT_32(F, i) LUT_32(F, (i) + 32)
+#define LUT_128(F, i)		LUT_64(F, i) LUT_64(F, (i) + 64)
+#define LUT_256(F, i)		LUT_128(F, i) LUT_128(F, (i) + 128)
+#define LUT_512(F, i)		LUT_256(F, i) LUT_256(F, (i) + 256)
+#define LUT_1024(F, i)		LUT_512(F, i) LUT_512(F, (i) + 512)
+#define LUT_2048(F, i)		LUT_1024(F, i) LUT_1024(F, (i) + 1024)
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+
+const int16_t hdc1000_lut_temp_11bit[2048] = { LUT_2048(TEMP_11BIT, 0) };
+
+const uint16_t hdc1000_lut_humi_11bit[2048] = { LUT_2048(HUMI_11BIT, 0) };
+
+const uint16_t hdc1000_lut_humi_8bit[256] = { LUT_256(HUMI_8BIT, 0) };
+
+/*******************************************************************************
+* Public functions
+*******************************************************************************/
+
+/// <summary>
+///		Convert arrays of register values to hundredths by resolution
+/// <para>Channels in 11-bit or 8-bit resolution are converted by table
+/// lookup, 14-bit channels as hdc1000_convert_batch() with
+/// HDC1000_FMT_CENTI.</para>
+/// </summary>
+/// <param name="p_temp_raw">Temperature register values or NULL</param>
+/// <param name="p_humi_raw">Humidity register values or NULL</param>
+/// <param name="count">Number of elements in each array</param>
+/// <param name="resolution">HDC1000_CFG_TEMP_* | HDC1000_CFG_HUMI_*
+/// resolution the values were measured with</param>
+/// <param name="p_temp_centi">Temperature output in 0.01 degC or NULL
+/// </param>
+/// <param name="p_humi_centi">Humidity output in 0.01 %RH or NULL</param>
+///
+void
+hdc1000_convert_lut(const uint16_t* p_temp_raw, const uint16_t* p_humi_raw,
+	size_t count, uint8_t resolution, int16_t* p_temp_centi,
+	uint16_t* p_humi_centi)
+{
+	const uint16_t* p_humi_lut = NULL;
+	uint8_t humi_shift = 0;
+	size_t i;
+
+	if (p_temp_raw != NULL && p_temp_centi != NULL)
+	{
+		if (resolution & HDC1000_CFG_TEMP_11BIT)
+		{
+			for (i = 0; i < count; i++)
+			{
+				p_temp_centi[i] = hdc1000_lut_temp_11bit[
+					p_temp_raw[i] >> HDC1000_LUT_SHIFT_11BIT];
+			}
+		}
+		else
+		{
+			hdc1000_convert_batch(p_temp_raw, NULL, count,
+				HDC1000_FMT_CENTI, p_temp_centi, NULL);
+		}
+	}
+
+	if (p_humi_raw == NULL || p_humi_centi == NULL)
+	{
+		return;
+	}
+
+	switch (resolution & HDC1000_CFG_HUMI_RES_MASK)
+	{
+	case HDC1000_CFG_HUMI_11BIT:
+		p_humi_lut = hdc1000_lut_humi_11bit;
+		humi_shift = HDC1000_LUT_SHIFT_11BIT;
+		break;
+
+	case HDC1000_CFG_HUMI_8BIT:
+		p_humi_lut = hdc1000_lut_humi_8bit;
+		humi_shift = HDC1000_LUT_SHIFT_8BIT;
+		break;
+	}
+
+	if (p_humi_lut == NULL)
+	{
+		hdc1000_convert_batch(NULL, p_humi_raw, count, HDC1000_FMT_CENTI,
+			NULL, p_humi_centi);
+		return;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		p_humi_centi[i] = p_humi_lut[p_humi_raw[i] >> humi_shift];
+	}
+}
+
+/* [] END OF FILE */
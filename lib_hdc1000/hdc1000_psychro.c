@@ -0,0 +1,315 @@
+/***************************************************************************//**
+* @file    hdc1000_psychro.c
+* @version 1.0.0
+*
+* @brief Derived humidity metrics from HDC1000 register values.
+*
+* @par Description
+*    Dew point, absolute humidity and heat index computed directly from
+*    Temperature and Humidity register values. Magnus formula over water
+*    (coefficients 17.62 and 243.12 degC) and natural logarithm come from
+*    interpolated tables, so no log() or exp() is called. Dew point and
+*    absolute humidity use integer arithmetic only, heat index is a single
+*    precision polynomial.
+*
+*    Errors against the Magnus formula in double precision, over all
+*    temperatures and 1 %RH to 100 %RH:
+*        dew point          +-0.01 degC
+*        absolute humidity  +-0.15 %, at least +-0.01 g/m3
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000.h"
+
+#include <math.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+// Magnus coefficients, b in hundredths of degC, a in Q16
+#define MAGNUS_A_Q16		1154744
+#define MAGNUS_B_CENTI		24312
+
+#define LN2_Q16				45426
+
+// Absolute humidity = 216.7 * e / T, e in 0.01 Pa, T in 0.01 K
+#define ABS_HUMI_FACTOR		2167
+#define KELVIN_CENTI		27315
+
+/*******************************************************************************
+* Constants
+*******************************************************************************/
+
+// Saturation vapour pressure in 0.01 Pa at register values i * 256,
+// T = 165 * i / 256 - 40 degC:
+//     es = 611.2 * exp(17.62 * T / (243.12 + T)) Pa
+static const uint32_t es_table[257] = {
+	1902, 2033, 2173, 2321, 2478, 2644, 2821, 3008, 3206, 3416, 3639, 3874,
+	4123, 4386, 4665, 4959, 5270, 5598, 5945, 6310, 6696, 7103, 7532, 7984,
+	8461, 8962, 9491, 10047, 10632, 11248, 11895, 12575, 13291, 14042, 14831,
+	15660, 16530, 17442, 18400, 19404, 20457, 21561, 22717, 23929, 25198,
+	26527, 27917, 29373, 30895, 32488, 34153, 35894, 37713, 39614, 41600,
+	43673, 45838, 48098, 50456, 52916, 55482, 58158, 60947, 63855, 66885,
+	70041, 73329, 76753, 80317, 84027, 87888, 91904, 96083, 100428, 104946,
+	109642, 114523, 119594, 124863, 130335, 136017, 141917, 148041, 154396,
+	160990, 167831, 174926, 182283, 189912, 197819, 206014, 214506, 223303,
+	232415, 241852, 251623, 261739, 272209, 283044, 294255, 305853, 317849,
+	330255, 343082, 356342, 370048, 384212, 398848, 413967, 429585, 445714,
+	462369, 479564, 497313, 515632, 534536, 554040, 574160, 594914, 616316,
+	638385, 661138, 684592, 708765, 733675, 759342, 785785, 813022, 841074,
+	869961, 899703, 930323, 961840, 994277, 1027656, 1062000, 1097332,
+	1133676, 1171054, 1209492, 1249015, 1289647, 1331414, 1374343, 1418460,
+	1463793, 1510367, 1558213, 1607358, 1657831, 1709661, 1762879, 1817515,
+	1873600, 1931166, 1990244, 2050866, 2113067, 2176880, 2242338, 2309476,
+	2378330, 2448935, 2521327, 2595544, 2671623, 2749601, 2829518, 2911412,
+	2995323, 3081292, 3169359, 3259566, 3351955, 3446569, 3543451, 3642645,
+	3744196, 3848149, 3954549, 4063444, 4174880, 4288906, 4405569, 4524918,
+	4647005, 4771878, 4899589, 5030190, 5163734, 5300273, 5439861, 5582553,
+	5728404, 5877471, 6029809, 6185476, 6344530, 6507031, 6673037, 6842609,
+	7015807, 7192694, 7373333, 7557785, 7746116, 7938391, 8134673, 8335031,
+	8539530, 8748240, 8961228, 9178563, 9400316, 9626559, 9857362, 10092798,
+	10332940, 10577864, 10827643, 11082353, 11342072, 11606875, 11876843,
+	12152053, 12432586, 12718522, 13009943, 13306931, 13609570, 13917943,
+	14232136, 14552234, 14878324, 15210493, 15548831, 15893425, 16244366,
+	16601745, 16965654, 17336186, 17713433, 18097492, 18488456, 18886422,
+	19291488, 19703751, 20123310, 20550266, 20984718, 21426768, 21876519,
+	22334074, 22799538, 23273016, 23754613, 24244437
+};
+
+// Magnus exponent ln(es / 611.2 Pa) = 17.62 * T / (243.12 + T) in Q16 at
+// register values i * 512, T = 165 * i / 128 - 40 degC
+static const int32_t magnus_table[129] = {
+	-227401, -218685, -210078, -201578, -193184, -184893, -176703, -168612,
+	-160620, -152723, -144921, -137211, -129592, -122062, -114620, -107265,
+	-99994, -92807, -85701, -78676, -71730, -64861, -58070, -51353, -44711,
+	-38141, -31643, -25215, -18856, -12566, -6343, -186, 5907, 11935, 17901,
+	23804, 29647, 35429, 41152, 46817, 52425, 57976, 63472, 68913, 74299,
+	79633, 84914, 90144, 95323, 100451, 105530, 110561, 115543, 120478,
+	125367, 130209, 135007, 139759, 144467, 149132, 153754, 158334, 162872,
+	167369, 171825, 176241, 180618, 184955, 189255, 193516, 197740, 201927,
+	206077, 210192, 214270, 218314, 222323, 226298, 230240, 234148, 238023,
+	241865, 245676, 249454, 253202, 256918, 260605, 264261, 267887, 271483,
+	275051, 278590, 282101, 285583, 289038, 292466, 295866, 299240, 302588,
+	305909, 309204, 312474, 315719, 318939, 322135, 325306, 328452, 331576,
+	334675, 337752, 340805, 343836, 346844, 349830, 352793, 355736, 358656,
+	361556, 364434, 367292, 370128, 372945, 375741, 378518, 381275, 384012,
+	386730, 389429, 392109
+};
+
+// ln(1 + i / 32) in Q16
+static const uint16_t ln_table[33] = {
+	0, 2017, 3973, 5873, 7719, 9515, 11262, 12965, 14624, 16242, 17821,
+	19364, 20870, 22343, 23783, 25193, 26573, 27924, 29248, 30546, 31818,
+	33067, 34292, 35494, 36675, 37835, 38975, 40095, 41196, 42280, 43345,
+	44394, 45426
+};
+
+/*******************************************************************************
+* Forward declarations of private functions
+*******************************************************************************/
+
+static uint32_t
+hdc1000_vapour_pressure(uint16_t temp_raw, uint16_t humi_raw);
+
+static int32_t
+hdc1000_ln_q16(uint32_t x);
+
+static uint32_t
+hdc1000_abs_humi_from(uint16_t temp_raw, uint32_t vapour_pressure);
+
+/*******************************************************************************
+* Public functions
+*******************************************************************************/
+
+/// <summary>
+///		Dew point from register values
+/// </summary>
+/// <param name="temp_raw">Temperature register value</param>
+/// <param name="humi_raw">Humidity register value</param>
+/// <returns>Dew point in 0.01 degrees Celsius</returns>
+///
+int16_t
+hdc1000_dew_point_centi(uint16_t temp_raw, uint16_t humi_raw)
+{
+	uint32_t i = temp_raw >> 9;
+	int32_t frac = temp_raw & 0x1FF;
+	int64_t gamma;
+	int64_t num;
+	int64_t den;
+
+	// ln(e / 611.2 Pa) = Magnus exponent + ln(RH / 100 %)
+	gamma = magnus_table[i] + (((int64_t)(magnus_table[i + 1] -
+		magnus_table[i]) * frac + 256) >> 9);
+	gamma += hdc1000_ln_q16((humi_raw > 0) ? humi_raw : 1) - 16 * LN2_Q16;
+
+	// Inverse Magnus formula, den is positive for any register values
+	num = MAGNUS_B_CENTI * gamma;
+	den = MAGNUS_A_Q16 - gamma;
+	num += (num < 0) ? -(den / 2) : den / 2;
+	return (int16_t)(num / den);
+}
+
+/// <summary>
+///		Absolute humidity from register values
+/// </summary>
+/// <param name="temp_raw">Temperature register value</param>
+/// <param name="humi_raw">Humidity register value</param>
+/// <returns>Water vapour density in 0.01 g/m3</returns>
+///
+uint32_t
+hdc1000_abs_humi_centi(uint16_t temp_raw, uint16_t humi_raw)
+{
+	return hdc1000_abs_humi_from(temp_raw,
+		hdc1000_vapour_pressure(temp_raw, humi_raw));
+}
+
+/// <summary>
+///		Heat index (apparent temperature) from register values
+/// <para>NWS formula: Steadman approximation below 80 degF, Rothfusz
+/// regression with low and high humidity adjustments above.</para>
+/// </summary>
+/// <param name="temp_raw">Temperature register value</param>
+/// <param name="humi_raw">Humidity register value</param>
+/// <returns>Heat index in 0.01 degrees Celsius</returns>
+///
+int16_t
+hdc1000_heat_index_centi(uint16_t temp_raw, uint16_t humi_raw)
+{
+	float t = ((float)temp_raw * (165.0f / 65536.0f) - 40.0f) * 1.8f + 32.0f;
+	float rh = (float)humi_raw * (100.0f / 65536.0f);
+	float hi;
+	float centi;
+
+	hi = 0.5f * (t + 61.0f + (t - 68.0f) * 1.2f + rh * 0.094f);
+	hi = 0.5f * (hi + t);
+
+	if (hi >= 80.0f)
+	{
+		hi = -42.379f + 2.04901523f * t + 10.14333127f * rh
+			- 0.22475541f * t * rh - 0.00683783f * t * t
+			- 0.05481717f * rh * rh + 0.00122874f * t * t * rh
+			+ 0.00085282f * t * rh * rh - 0.00000199f * t * t * rh * rh;
+
+		if (rh < 13.0f && t > 80.0f && t < 112.0f)
+		{
+			hi -= ((13.0f - rh) / 4.0f) *
+				sqrtf((17.0f - fabsf(t - 95.0f)) / 17.0f);
+		}
+		else if (rh > 85.0f && t > 80.0f && t < 87.0f)
+		{
+			hi += ((rh - 85.0f) / 10.0f) * ((87.0f - t) / 5.0f);
+		}
+	}
+
+	centi = (hi - 32.0f) * (100.0f / 1.8f);
+	if (centi > 32767.0f)
+	{
+		return INT16_MAX;
+	}
+	return (int16_t)(centi + ((centi < 0.0f) ? -0.5f : 0.5f));
+}
+
+/// <summary>
+///		Derived metrics of register value arrays
+/// <para>Outputs passed as NULL are not computed.</para>
+/// </summary>
+/// <param name="p_temp_raw">Temperature register values</param>
+/// <param name="p_humi_raw">Humidity register values</param>
+/// <param name="count">Number of samples</param>
+/// <param name="p_dew_point">Dew point output in 0.01 degC or NULL</param>
+/// <param name="p_abs_humi">Absolute humidity output in 0.01 g/m3 or NULL
+/// </param>
+/// <param name="p_heat_index">Heat index output in 0.01 degC or NULL
+/// </param>
+///
+void
+hdc1000_psychro_batch(const uint16_t* p_temp_raw, const uint16_t* p_humi_raw,
+	size_t count, int16_t* p_dew_point, uint32_t* p_abs_humi,
+	int16_t* p_heat_index)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		if (p_dew_point != NULL)
+		{
+			p_dew_point[i] = hdc1000_dew_point_centi(p_temp_raw[i],
+				p_humi_raw[i]);
+		}
+		if (p_abs_humi != NULL)
+		{
+			p_abs_humi[i] = hdc1000_abs_humi_centi(p_temp_raw[i],
+				p_humi_raw[i]);
+		}
+		if (p_heat_index != NULL)
+		{
+			p_heat_index[i] = hdc1000_heat_index_centi(p_temp_raw[i],
+				p_humi_raw[i]);
+		}
+	}
+}
+
+/*******************************************************************************
+* Private functions
+*******************************************************************************/
+
+/// <summary>
+///		Partial vapour pressure in 0.01 Pa
+/// </summary>
+static uint32_t
+hdc1000_vapour_pressure(uint16_t temp_raw, uint16_t humi_raw)
+{
+	uint32_t i = temp_raw >> 8;
+	uint32_t frac = temp_raw & 0xFF;
+	uint64_t es;
+
+	// Linear interpolation between table points
+	es = ((uint64_t)es_table[i] * (256 - frac) +
+		(uint64_t)es_table[i + 1] * frac + 128) >> 8;
+
+	return (uint32_t)((es * humi_raw + 32768) >> 16);
+}
+
+/// <summary>
+///		Natural logarithm in Q16 of a positive integer
+/// </summary>
+static int32_t
+hdc1000_ln_q16(uint32_t x)
+{
+	int32_t k = 31;
+	uint32_t i;
+	uint32_t frac;
+
+	while (!(x & 0x80000000u))
+	{
+		x <<= 1;
+		k--;
+	}
+
+	// x = 2^k * (1 + i / 32 + frac / 2^26)
+	i = (x >> 26) & 0x1F;
+	frac = (x >> 10) & 0xFFFF;
+
+	return k * LN2_Q16 + (int32_t)ln_table[i] + (int32_t)(
+		((uint32_t)(ln_table[i + 1] - ln_table[i]) * frac + 32768) >> 16);
+}
+
+/// <summary>
+///		Absolute humidity in 0.01 g/m3 from vapour pressure
+/// </summary>
+static uint32_t
+hdc1000_abs_humi_from(uint16_t temp_raw, uint32_t vapour_pressure)
+{
+	uint32_t kelvin = (uint32_t)(KELVIN_CENTI +
+		hdc1000_temp_raw_to_centi(temp_raw));
+	uint64_t den = 10 * (uint64_t)kelvin;
+
+	return (uint32_t)(((uint64_t)ABS_HUMI_FACTOR * vapour_pressure +
+		den / 2) / den);
+}
+
+/* [] END OF FILE */
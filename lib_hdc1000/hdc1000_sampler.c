@@ -0,0 +1,458 @@
+/***************************************************************************//**
+* @file    hdc1000_sampler.c
+* @version 1.0.0
+*
+* @brief Background continuous sampler for HDC1000 sensor.
+*
+* @par Description
+*    Ring buffer indices run freely and are masked on access. Producer
+*    owns head, consumer owns tail; each side publishes its index with
+*    release ordering and reads the other one with acquire ordering. When
+*    the ring is full, the new sample is dropped so the producer never
+*    waits for the consumer.
+*
+*    Heater schedule is evaluated on the sampler thread. Sample start time
+*    within the heater cycle decides whether the sample is heated, and
+*    during the burst further conversions are run until the next period
+*    boundary would be missed.
+*
+*    Sampler thread sleeps on a condition variable timed on the monotonic
+*    clock, so hdc1000_sampler_stop() wakes it without waiting out the
+*    period. Builds as C11 with POSIX.1-2008 threads.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include "hdc1000_sampler.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+* Macros and #define Constants
+*******************************************************************************/
+
+// Heater cycle phases
+#define HEATER_IDLE			0
+#define HEATER_BURST		1
+#define HEATER_BLACKOUT		2
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+
+struct hdc1000_sampler_struct {
+	hdc1000_t* p_hdc;
+	uint32_t period_us;
+	pthread_t thread;
+	atomic_int running;
+	pthread_mutex_t lock;		// Guards stop against thread sleep
+	pthread_cond_t wake;		// Signalled by stop, monotonic clock
+
+	hdc1000_sample_t* ring;
+	uint32_t mask;				// Ring capacity - 1
+	atomic_uint head;			// Next slot to write, producer owned
+	atomic_uint tail;			// Next slot to read, consumer owned
+	atomic_uint dropped;
+
+	uint32_t heater_cycle_us;	// Heater cycle period, 0 if disabled
+	uint32_t heater_burst_us;	// Heating time at start of each cycle
+	uint32_t heater_blackout_us;	// Cool down time after burst
+	uint8_t heater_mode;		// HDC1000_HEATER_MARK or _SUPPRESS
+};
+
+/*******************************************************************************
+* Forward declarations of private functions
+*******************************************************************************/
+
+static void*
+hdc1000_sampler_thread(void* arg);
+
+static int
+hdc1000_sampler_acquire(hdc1000_sampler_t* p_sampler,
+	hdc1000_sample_t* p_sample);
+
+static void
+hdc1000_sampler_publish(hdc1000_sampler_t* p_sampler,
+	const hdc1000_sample_t* p_sample);
+
+static int
+hdc1000_sampler_heater_phase(hdc1000_sampler_t* p_sampler, 
+	uint64_t elapsed_us);
+
+static void
+hdc1000_sampler_heat(hdc1000_sampler_t* p_sampler, uint64_t start_us,
+	uint64_t until_us);
+
+static uint64_t
+hdc1000_sampler_time_us(void);
+
+/*******************************************************************************
+* Public functions
+*******************************************************************************/
+
+hdc1000_sampler_t
+*hdc1000_sampler_create(hdc1000_t* p_hdc, uint32_t period_us,
+	uint32_t capacity)
+{
+	hdc1000_sampler_t* p_sampler;
+	pthread_condattr_t cond_attr;
+	int result;
+
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+	{
+		return NULL;
+	}
+
+	p_sampler = (hdc1000_sampler_t*)malloc(sizeof(hdc1000_sampler_t));
+	if (p_sampler == NULL)
+	{
+		return NULL;
+	}
+
+	p_sampler->ring = 
+		(hdc1000_sample_t*)malloc(capacity * sizeof(hdc1000_sample_t));
+	if (p_sampler->ring == NULL)
+	{
+		free(p_sampler);
+		return NULL;
+	}
+
+	// Timed waits use the same clock as the sampling deadlines
+	result = pthread_condattr_init(&cond_attr);
+	if (result == 0)
+	{
+		result = pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+		if (result == 0)
+		{
+			result = pthread_cond_init(&p_sampler->wake, &cond_attr);
+		}
+		pthread_condattr_destroy(&cond_attr);
+	}
+	if (result == 0 && pthread_mutex_init(&p_sampler->lock, NULL) != 0)
+	{
+		pthread_cond_destroy(&p_sampler->wake);
+		result = -1;
+	}
+	if (result != 0)
+	{
+		free(p_sampler->ring);
+		free(p_sampler);
+		return NULL;
+	}
+
+	p_sampler->p_hdc = p_hdc;
+	p_sampler->period_us = period_us;
+	p_sampler->mask = capacity - 1;
+	atomic_init(&p_sampler->running, 0);
+	atomic_init(&p_sampler->head, 0);
+	atomic_init(&p_sampler->tail, 0);
+	atomic_init(&p_sampler->dropped, 0);
+	p_sampler->heater_cycle_us = 0;
+	p_sampler->heater_burst_us = 0;
+	p_sampler->heater_blackout_us = 0;
+	p_sampler->heater_mode = HDC1000_HEATER_MARK;
+
+	return p_sampler;
+}
+
+void
+hdc1000_sampler_destroy(hdc1000_sampler_t* p_sampler)
+{
+	hdc1000_sampler_stop(p_sampler);
+	pthread_cond_destroy(&p_sampler->wake);
+	pthread_mutex_destroy(&p_sampler->lock);
+	free(p_sampler->ring);
+	free(p_sampler);
+}
+
+int
+hdc1000_sampler_set_heater(hdc1000_sampler_t* p_sampler, uint32_t cycle_us,
+	uint8_t duty, uint32_t blackout_us, uint8_t mode)
+{
+	if (atomic_load(&p_sampler->running) || duty > 100)
+	{
+		return -1;
+	}
+
+	p_sampler->heater_cycle_us = cycle_us;
+	p_sampler->heater_burst_us = (uint32_t)((uint64_t)cycle_us * duty / 100);
+	p_sampler->heater_blackout_us = blackout_us;
+	p_sampler->heater_mode = mode;
+	return 0;
+}
+
+int
+hdc1000_sampler_start(hdc1000_sampler_t* p_sampler)
+{
+	// Zero period would run acquisitions back to back
+	if (atomic_load(&p_sampler->running) || p_sampler->period_us == 0)
+	{
+		return -1;
+	}
+
+	atomic_store(&p_sampler->running, 1);
+	if (pthread_create(&p_sampler->thread, NULL, hdc1000_sampler_thread,
+		p_sampler) != 0)
+	{
+		atomic_store(&p_sampler->running, 0);
+		return -1;
+	}
+	return 0;
+}
+
+void
+hdc1000_sampler_stop(hdc1000_sampler_t* p_sampler)
+{
+	int was_running;
+
+	// Under the lock the thread is either running or waiting, never
+	// between its running check and the wait
+	pthread_mutex_lock(&p_sampler->lock);
+	was_running = atomic_exchange(&p_sampler->running, 0);
+	pthread_cond_signal(&p_sampler->wake);
+	pthread_mutex_unlock(&p_sampler->lock);
+
+	if (was_running)
+	{
+		pthread_join(p_sampler->thread, NULL);
+	}
+}
+
+size_t
+hdc1000_sampler_drain(hdc1000_sampler_t* p_sampler,
+	hdc1000_sample_t* p_samples, size_t max_samples)
+{
+	unsigned int tail = atomic_load_explicit(&p_sampler->tail,
+		memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&p_sampler->head,
+		memory_order_acquire);
+	size_t count = head - tail;
+	size_t i;
+
+	if (count > max_samples)
+	{
+		count = max_samples;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		p_samples[i] = p_sampler->ring[(tail + i) & p_sampler->mask];
+	}
+
+	atomic_store_explicit(&p_sampler->tail, tail + (unsigned int)count,
+		memory_order_release);
+	return count;
+}
+
+uint32_t
+hdc1000_sampler_dropped(hdc1000_sampler_t* p_sampler)
+{
+	return atomic_load_explicit(&p_sampler->dropped, memory_order_relaxed);
+}
+
+/*******************************************************************************
+* Private functions
+*******************************************************************************/
+
+/// <summary>
+///		Sampler thread, acquires samples on absolute period boundaries
+/// </summary>
+static void*
+hdc1000_sampler_thread(void* arg)
+{
+	hdc1000_sampler_t* p_sampler = (hdc1000_sampler_t*)arg;
+	hdc1000_t* p_hdc = p_sampler->p_hdc;
+	hdc1000_sample_t sample;
+	struct timespec next;
+	uint64_t start_us;
+	int phase;
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	start_us = (uint64_t)next.tv_sec * 1000000 + 
+		(uint64_t)next.tv_nsec / 1000;
+
+	while (atomic_load_explicit(&p_sampler->running, memory_order_relaxed))
+	{
+		phase = hdc1000_sampler_heater_phase(p_sampler,
+			hdc1000_sampler_time_us() - start_us);
+		if (p_sampler->heater_cycle_us > 0)
+		{
+			// Configuration is written only when heater state changes
+			hdc1000_set_heater(p_hdc, (phase == HEATER_BURST) ?
+				HDC1000_CFG_HEAT_ON : HDC1000_CFG_HEAT_OFF);
+
+			// Blackout readings are biased too, keep them out of filters
+			hdc1000_hold_filter(p_hdc, phase != HEATER_IDLE);
+		}
+
+		// Failed acquisitions are skipped, next period tries again
+		if (hdc1000_sampler_acquire(p_sampler, &sample) == HDC1000_OK)
+		{
+			sample.flags = (phase != HEATER_IDLE) ? 
+				HDC1000_SAMPLE_HEATED : 0;
+			if (sample.flags == 0 || 
+				p_sampler->heater_mode != HDC1000_HEATER_SUPPRESS)
+			{
+				hdc1000_sampler_publish(p_sampler, &sample);
+			}
+		}
+
+		// Absolute deadlines keep the rate free of acquisition time drift
+		next.tv_sec += p_sampler->period_us / 1000000;
+		next.tv_nsec += (long)(p_sampler->period_us % 1000000) * 1000;
+		if (next.tv_nsec >= 1000000000)
+		{
+			next.tv_sec++;
+			next.tv_nsec -= 1000000000;
+		}
+
+		if (phase == HEATER_BURST)
+		{
+			hdc1000_sampler_heat(p_sampler, start_us, 
+				(uint64_t)next.tv_sec * 1000000 + 
+				(uint64_t)next.tv_nsec / 1000);
+		}
+
+		pthread_mutex_lock(&p_sampler->lock);
+		while (atomic_load_explicit(&p_sampler->running, 
+			memory_order_relaxed) && pthread_cond_timedwait(&p_sampler->wake,
+			&p_sampler->lock, &next) != ETIMEDOUT)
+		{
+		}
+		pthread_mutex_unlock(&p_sampler->lock);
+	}
+
+	if (p_sampler->heater_cycle_us > 0)
+	{
+		hdc1000_set_heater(p_hdc, HDC1000_CFG_HEAT_OFF);
+		hdc1000_hold_filter(p_hdc, 0);
+	}
+
+	return NULL;
+}
+
+/// <summary>
+///		Acquire one sample, in a single conversion if combined mode is set
+/// </summary>
+/// <returns>HDC1000_OK or negative status</returns>
+static int
+hdc1000_sampler_acquire(hdc1000_sampler_t* p_sampler,
+	hdc1000_sample_t* p_sample)
+{
+	hdc1000_t* p_hdc = p_sampler->p_hdc;
+	int result;
+
+	p_sample->timestamp_us = hdc1000_sampler_time_us();
+
+	if (p_hdc->config & HDC1000_CFG_BOTH_TEMP_HUMI)
+	{
+		return hdc1000_read_temp_humi_raw(p_hdc, &p_sample->temp_raw,
+			&p_sample->humi_raw);
+	}
+
+	result = hdc1000_read_temp_raw(p_hdc, &p_sample->temp_raw);
+	if (result == HDC1000_OK)
+	{
+		result = hdc1000_read_humi_raw(p_hdc, &p_sample->humi_raw);
+	}
+	return result;
+}
+
+/// <summary>
+///		Store sample to ring buffer or drop it if the buffer is full
+/// </summary>
+static void
+hdc1000_sampler_publish(hdc1000_sampler_t* p_sampler,
+	const hdc1000_sample_t* p_sample)
+{
+	unsigned int head = atomic_load_explicit(&p_sampler->head,
+		memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&p_sampler->tail,
+		memory_order_acquire);
+
+	if (head - tail > p_sampler->mask)
+	{
+		atomic_fetch_add_explicit(&p_sampler->dropped, 1, 
+			memory_order_relaxed);
+		return;
+	}
+
+	p_sampler->ring[head & p_sampler->mask] = *p_sample;
+	atomic_store_explicit(&p_sampler->head, head + 1, memory_order_release);
+}
+
+/// <summary>
+///		Get heater cycle phase at elapsed time since sampler start
+/// </summary>
+static int
+hdc1000_sampler_heater_phase(hdc1000_sampler_t* p_sampler, 
+	uint64_t elapsed_us)
+{
+	uint64_t cycle_pos;
+
+	if (p_sampler->heater_cycle_us == 0 || p_sampler->heater_burst_us == 0)
+	{
+		return HEATER_IDLE;
+	}
+
+	cycle_pos = elapsed_us % p_sampler->heater_cycle_us;
+	if (cycle_pos < p_sampler->heater_burst_us)
+	{
+		return HEATER_BURST;
+	}
+	if (cycle_pos < (uint64_t)p_sampler->heater_burst_us + 
+		p_sampler->heater_blackout_us)
+	{
+		return HEATER_BLACKOUT;
+	}
+	return HEATER_IDLE;
+}
+
+/// <summary>
+///		Run heated conversions until burst ends or until_us would be missed
+/// </summary>
+static void
+hdc1000_sampler_heat(hdc1000_sampler_t* p_sampler, uint64_t start_us,
+	uint64_t until_us)
+{
+	hdc1000_t* p_hdc = p_sampler->p_hdc;
+	uint64_t read_time;
+	uint64_t now = hdc1000_sampler_time_us();
+	uint16_t temp_raw;
+
+	// Each read averages filter_oversample conversions
+	read_time = (uint64_t)hdc1000_get_conversion_time(p_hdc, 
+		HDC1000_REG_TEMP) * p_hdc->filter_oversample;
+
+	while (now + read_time < until_us &&
+		hdc1000_sampler_heater_phase(p_sampler, now - start_us) == 
+		HEATER_BURST &&
+		atomic_load_explicit(&p_sampler->running, memory_order_relaxed))
+	{
+		// Result is discarded, conversion only drives the heater
+		if (hdc1000_read_temp_raw(p_hdc, &temp_raw) != HDC1000_OK)
+		{
+			break;
+		}
+		now = hdc1000_sampler_time_us();
+	}
+}
+
+static uint64_t
+hdc1000_sampler_time_us(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,658 @@
+/***************************************************************************//**
+* @file    hdc1000_sim.c
+* @version 1.0.0
+*
+* @brief Simulated HDC1000 device.
+*
+* @par Description
+*    Models register file, conversion timing per mode and resolution,
+*    DRDYn signal, heater self heating and battery status bit. Platform
+*    messages are served on a virtual clock, I2C transfers advance it
+*    by their duration at the configured bus speed.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_sim.h"
+
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+#define SIM(p_hdc)          ((hdc1000_sim_t *)(p_hdc)->user_data)
+
+#define CONV_TEMP           0x01
+#define CONV_HUMI           0x02
+
+// Configuration bits writable by host
+#define CFG_WRITABLE        (HDC1000_SIM_CFG_HEAT | HDC1000_SIM_CFG_MODE | \
+                             HDC1000_SIM_CFG_TRES | HDC1000_SIM_CFG_HRES)
+
+#define CFG_DEFAULT         HDC1000_SIM_CFG_MODE
+
+#define BTST_THRESHOLD_V    2.8
+
+// Relative humidity drop per degree of self heating
+#define HEATER_RH_FACTOR    0.065
+
+/*******************************************************************************
+* Forward declarations of private functions
+*******************************************************************************/
+
+static int
+sim_address_nack(hdc1000_sim_t *p_sim, uint8_t i2c_addr);
+
+static int
+sim_transaction(hdc1000_sim_t *p_sim, uint8_t i2c_addr,
+    hdc1000_segment_t *segs, uint8_t count);
+
+static int
+sim_wait_drdyn(hdc1000_sim_t *p_sim, uint32_t timeout);
+
+static int
+sim_write(hdc1000_sim_t *p_sim, const uint8_t *data, uint8_t length);
+
+static int
+sim_read(hdc1000_sim_t *p_sim, uint8_t *buffer, uint8_t length);
+
+static void
+sim_bus_time(hdc1000_sim_t *p_sim, uint8_t length);
+
+static void
+sim_start_conversion(hdc1000_sim_t *p_sim);
+
+static void
+sim_latch_results(hdc1000_sim_t *p_sim);
+
+static uint16_t
+sim_result_mask(uint16_t config, uint8_t reg_addr);
+
+static uint16_t
+sim_reg_value(hdc1000_sim_t *p_sim, uint8_t reg_addr);
+
+/*******************************************************************************
+* Public functions
+*******************************************************************************/
+
+/// <summary>
+///		Initialize simulated device to power-up state
+/// <para>Ambient conditions default to 25 degC, 50 %RH and 3.3 V supply,
+/// bus runs at 100 kHz, DRDYn edge events and transaction messages are
+/// supported.</para>
+/// </summary>
+/// <param name="p_sim">Pointer to hdc1000_sim_t data struct</param>
+void
+hdc1000_sim_init(hdc1000_sim_t *p_sim)
+{
+    memset(p_sim, 0, sizeof(hdc1000_sim_t));
+
+    p_sim->i2c_addr = HDC1000_I2C_ADDR;
+    p_sim->config_reg = CFG_DEFAULT;
+    p_sim->serid[0] = 0x1234;
+    p_sim->serid[1] = 0x5678;
+    p_sim->serid[2] = 0x9A00;
+
+    p_sim->ambient_temp = 25.0;
+    p_sim->ambient_humi = 50.0;
+    p_sim->vdd = 3.3;
+    p_sim->heater_rate = 100.0;
+    p_sim->cool_rate = 0.5;
+    p_sim->edge_events = 1;
+    p_sim->transaction_msgs = 1;
+
+    p_sim->bus_hz = 100000;
+    p_sim->gpio_read_us = 1;
+}
+
+/// <summary>
+///		Initialize HDC1000 driver connected to simulated device
+/// </summary>
+/// <param name="p_sim">Pointer to initialized hdc1000_sim_t data struct
+/// </param>
+/// <param name="drdyn_pin">DRDYn pin number or -1 if not used</param>
+/// <returns>Pointer to hdc1000_t data structure</returns>
+hdc1000_t
+*hdc1000_sim_open(hdc1000_sim_t *p_sim, int drdyn_pin)
+{
+    hdc1000_t *p_hdc;
+
+    p_hdc = hdc1000_init_user(p_sim->i2c_addr, drdyn_pin, hdc1000_sim_cb,
+        p_sim);
+    if (p_hdc != NULL)
+    {
+        hdc1000_set_transaction(p_hdc, 1);
+    }
+    return p_hdc;
+}
+
+/// <summary>
+///		Free HDC1000 driver connected to simulated device
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+void
+hdc1000_sim_close(hdc1000_t *p_hdc)
+{
+    hdc1000_shutdown(p_hdc);
+}
+
+/// <summary>
+///		Platform callback serving driver messages from simulated device
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct, user_data has
+/// to point to hdc1000_sim_t</param>
+/// <returns>Non-negative on success, HDC1000_CB_* on failure</returns>
+int
+hdc1000_sim_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int,
+    void *arg_ptr)
+{
+    hdc1000_sim_t *p_sim = SIM(p_hdc);
+
+    p_sim->msg_count++;
+
+    if (msg <= HDC1000_MSG_I2C_WRITE_BYTES && 
+        sim_address_nack(p_sim, p_hdc->i2c_addr))
+    {
+        return HDC1000_CB_ERROR;
+    }
+
+    switch (msg)
+    {
+    case HDC1000_MSG_I2C_READ_BYTE:
+        return sim_read(p_sim, arg_ptr, 1);
+
+    case HDC1000_MSG_I2C_READ_BYTES:
+        return sim_read(p_sim, arg_ptr, arg_int);
+
+    case HDC1000_MSG_I2C_WRITE_BYTE:
+        return sim_write(p_sim, &arg_int, 1);
+
+    case HDC1000_MSG_I2C_WRITE_BYTES:
+        return sim_write(p_sim, arg_ptr, arg_int);
+
+    case HDC1000_MSG_I2C_RECOVER:
+        // Nine SCL pulses release SDA held by the slave, then STOP
+        p_sim->recoveries++;
+        p_sim->bus_stuck = 0;
+        if (p_sim->bus_hz > 0)
+        {
+            hdc1000_sim_advance(p_sim, 
+                (10 * 1000000 + p_sim->bus_hz - 1) / p_sim->bus_hz);
+        }
+        break;
+
+    case HDC1000_MSG_DELAY_MILLI:
+        p_sim->sleep_us += 1000 * (uint32_t)arg_int;
+        hdc1000_sim_advance(p_sim, 1000 * (uint32_t)arg_int);
+        break;
+
+    case HDC1000_MSG_DELAY_MICRO:
+        p_sim->sleep_us += *(uint32_t *)arg_ptr;
+        hdc1000_sim_advance(p_sim, *(uint32_t *)arg_ptr);
+        break;
+
+    case HDC1000_MSG_GET_TIME_MICRO:
+        *(uint64_t *)arg_ptr = p_sim->now_us;
+        break;
+
+    case HDC1000_MSG_GPIO_MODE_INPUT:
+        p_sim->drdyn_configured = 1;
+        break;
+
+    case HDC1000_MSG_GPIO_GET_VALUE:
+        // DRDYn is HIGH while conversion is in progress
+        hdc1000_sim_advance(p_sim, p_sim->gpio_read_us);
+        *(uint8_t *)arg_ptr = 
+            (p_sim->conv_regs != 0 || p_sim->drdyn_stuck) ? 1 : 0;
+        break;
+
+    case HDC1000_MSG_GPIO_WAIT_FALLING:
+        if (!p_sim->edge_events || !p_sim->drdyn_configured)
+        {
+            return HDC1000_CB_UNSUPPORTED;
+        }
+
+        return sim_wait_drdyn(p_sim, *(uint32_t *)arg_ptr);
+
+    case HDC1000_MSG_TRANSACTION:
+        if (!p_sim->transaction_msgs)
+        {
+            return HDC1000_CB_UNSUPPORTED;
+        }
+        return sim_transaction(p_sim, p_hdc->i2c_addr, arg_ptr, arg_int);
+
+    default:
+        return HDC1000_CB_UNSUPPORTED;
+    }
+
+    return 0;
+}
+
+/// <summary>
+///		Advance virtual clock
+/// <para>Applies heater self heating or cooling and latches conversion
+/// results once the conversion end time is reached.</para>
+/// </summary>
+/// <param name="p_sim">Pointer to hdc1000_sim_t data struct</param>
+/// <param name="usec">Time step in microseconds</param>
+void
+hdc1000_sim_advance(hdc1000_sim_t *p_sim, uint64_t usec)
+{
+    uint64_t end = p_sim->now_us + usec;
+    uint64_t heating_us = 0;
+
+    if (p_sim->conv_regs != 0 && (p_sim->config_reg & HDC1000_SIM_CFG_HEAT))
+    {
+        // Heater is on only during conversions
+        uint64_t heat_end = (end < p_sim->conv_end_us) ? 
+            end : p_sim->conv_end_us;
+        heating_us = (heat_end > p_sim->now_us) ? heat_end - p_sim->now_us : 0;
+    }
+
+    p_sim->heater_rise += p_sim->heater_rate * (double)heating_us / 1e6;
+    p_sim->heater_rise -= p_sim->cool_rate * (double)(usec - heating_us) / 1e6;
+    if (p_sim->heater_rise < 0.0)
+    {
+        p_sim->heater_rise = 0.0;
+    }
+
+    p_sim->now_us = end;
+
+    if (p_sim->conv_regs != 0 && p_sim->now_us >= p_sim->conv_end_us)
+    {
+        sim_latch_results(p_sim);
+    }
+}
+
+/// <summary>
+///		Clear statistics counters
+/// </summary>
+/// <param name="p_sim">Pointer to hdc1000_sim_t data struct</param>
+void
+hdc1000_sim_reset_stats(hdc1000_sim_t *p_sim)
+{
+    p_sim->msg_count = 0;
+    p_sim->transactions = 0;
+    p_sim->bus_bytes = 0;
+    p_sim->nacks = 0;
+    p_sim->recoveries = 0;
+    p_sim->sleep_us = 0;
+    p_sim->wait_us = 0;
+}
+
+/*******************************************************************************
+* Private functions
+*******************************************************************************/
+
+/// <summary>
+///		Fail I2C transaction when no device acknowledges the address
+/// </summary>
+/// <returns>1 if transaction was NACKed, 0 to serve it</returns>
+static int
+sim_address_nack(hdc1000_sim_t *p_sim, uint8_t i2c_addr)
+{
+    if (i2c_addr == p_sim->i2c_addr && !p_sim->bus_stuck && 
+        p_sim->fail_next == 0)
+    {
+        return 0;
+    }
+
+    if (p_sim->fail_next > 0)
+    {
+        p_sim->fail_next--;
+    }
+    sim_bus_time(p_sim, 0);
+    p_sim->nacks++;
+    return 1;
+}
+
+/// <summary>
+///		Run segments of HDC1000_MSG_TRANSACTION in order
+/// <para>Without DRDYn edge events a DRDYn wait is unsupported, as on
+/// platforms without GPIO edge events the driver then polls DRDYn.</para>
+/// </summary>
+/// <returns>0 on success, HDC1000_CB_* of the first failing segment
+/// </returns>
+static int
+sim_transaction(hdc1000_sim_t *p_sim, uint8_t i2c_addr,
+    hdc1000_segment_t *segs, uint8_t count)
+{
+    int result = 0;
+    uint8_t i;
+
+    // Refuse before touching the bus
+    for (i = 0; i < count; i++)
+    {
+        if (segs[i].type == HDC1000_SEG_WAIT_DRDYN && 
+            (!p_sim->edge_events || !p_sim->drdyn_configured))
+        {
+            return HDC1000_CB_UNSUPPORTED;
+        }
+    }
+
+    for (i = 0; i < count && result >= 0; i++)
+    {
+        switch (segs[i].type)
+        {
+        case HDC1000_SEG_WRITE:
+        case HDC1000_SEG_READ:
+            if (sim_address_nack(p_sim, i2c_addr))
+            {
+                return HDC1000_CB_ERROR;
+            }
+            result = (segs[i].type == HDC1000_SEG_WRITE) ?
+                sim_write(p_sim, segs[i].data, segs[i].length) :
+                sim_read(p_sim, segs[i].data, segs[i].length);
+            break;
+
+        case HDC1000_SEG_DELAY:
+            p_sim->sleep_us += segs[i].usec;
+            hdc1000_sim_advance(p_sim, segs[i].usec);
+            break;
+
+        case HDC1000_SEG_WAIT_DRDYN:
+            result = sim_wait_drdyn(p_sim, segs[i].usec);
+            break;
+
+        default:
+            return HDC1000_CB_ERROR;
+        }
+    }
+
+    return result;
+}
+
+/// <summary>
+///		Wait for DRDYn falling edge at end of conversion
+/// </summary>
+/// <param name="timeout">Maximum wait in microseconds</param>
+/// <returns>0 on DRDYn falling edge, HDC1000_CB_TIMEOUT</returns>
+static int
+sim_wait_drdyn(hdc1000_sim_t *p_sim, uint32_t timeout)
+{
+    uint64_t usec = 0;
+
+    if (p_sim->conv_regs != 0)
+    {
+        usec = p_sim->conv_end_us - p_sim->now_us;
+    }
+
+    if (p_sim->conv_regs == 0 || p_sim->drdyn_stuck || usec > timeout)
+    {
+        // Edge never comes without a conversion in progress
+        p_sim->wait_us += timeout;
+        hdc1000_sim_advance(p_sim, timeout);
+        return HDC1000_CB_TIMEOUT;
+    }
+
+    p_sim->wait_us += usec;
+    hdc1000_sim_advance(p_sim, usec);
+    return 0;
+}
+
+/// <summary>
+///		Serve I2C write transaction
+/// </summary>
+static int
+sim_write(hdc1000_sim_t *p_sim, const uint8_t *data, uint8_t length)
+{
+    uint16_t value;
+
+    sim_bus_time(p_sim, length);
+
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    switch (data[0])
+    {
+    case HDC1000_REG_TEMP:
+    case HDC1000_REG_HUMI:
+        if (length > 1)
+        {
+            // Result registers are read-only
+            p_sim->nacks++;
+            return HDC1000_CB_ERROR;
+        }
+        p_sim->pointer = data[0];
+        sim_start_conversion(p_sim);
+        return 0;
+
+    case HDC1000_REG_CONFIG:
+        p_sim->pointer = data[0];
+        if (length == 1)
+        {
+            return 0;
+        }
+
+        // Only MSB carries configuration bits, LSB is reserved
+        value = (uint16_t)(data[1] << 8);
+        if (value & HDC1000_SIM_CFG_RST)
+        {
+            p_sim->config_reg = CFG_DEFAULT |
+                (p_sim->config_reg & HDC1000_SIM_CFG_BTST);
+            return 0;
+        }
+        p_sim->config_reg = (value & CFG_WRITABLE) | 
+            (p_sim->config_reg & HDC1000_SIM_CFG_BTST);
+        return 0;
+
+    case HDC1000_REG_SERID_1:
+    case HDC1000_REG_SERID_2:
+    case HDC1000_REG_SERID_3:
+    case HDC1000_REG_MFID:
+    case HDC1000_REG_DEVID:
+        if (length > 1)
+        {
+            p_sim->nacks++;
+            return HDC1000_CB_ERROR;
+        }
+        p_sim->pointer = data[0];
+        return 0;
+
+    default:
+        // Unused address is NACKed after the pointer
+        p_sim->nacks++;
+        return HDC1000_CB_ERROR;
+    }
+}
+
+/// <summary>
+///		Serve I2C read transaction
+/// </summary>
+static int
+sim_read(hdc1000_sim_t *p_sim, uint8_t *buffer, uint8_t length)
+{
+    uint16_t words[2];
+    uint8_t i;
+
+    if ((p_sim->pointer == HDC1000_REG_TEMP || 
+        p_sim->pointer == HDC1000_REG_HUMI) && p_sim->conv_regs != 0 &&
+        p_sim->now_us < p_sim->conv_end_us)
+    {
+        // Measurement result is not ready yet, NACK after address
+        sim_bus_time(p_sim, 0);
+        p_sim->nacks++;
+        return HDC1000_CB_ERROR;
+    }
+
+    sim_bus_time(p_sim, length);
+
+    words[0] = sim_reg_value(p_sim, p_sim->pointer);
+    words[1] = 0xFFFF;
+    if (p_sim->pointer == HDC1000_REG_TEMP &&
+        (p_sim->config_reg & HDC1000_SIM_CFG_MODE))
+    {
+        words[1] = p_sim->humi_reg;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        buffer[i] = (i < 4) ? 
+            (uint8_t)(words[i / 2] >> ((i % 2) ? 0 : 8)) : 0xFF;
+    }
+    return 0;
+}
+
+/// <summary>
+///		Account I2C transaction with length data bytes and advance clock
+/// </summary>
+static void
+sim_bus_time(hdc1000_sim_t *p_sim, uint8_t length)
+{
+    // Start, address byte, data bytes, each byte 9 clocks, stop
+    uint32_t clocks = 1 + 9 * (1 + (uint32_t)length) + 1;
+
+    p_sim->transactions++;
+    p_sim->bus_bytes += 1 + (uint32_t)length;
+
+    if (p_sim->bus_hz > 0)
+    {
+        hdc1000_sim_advance(p_sim, 
+            ((uint64_t)clocks * 1000000 + p_sim->bus_hz - 1) / p_sim->bus_hz);
+    }
+}
+
+/// <summary>
+///		Start conversion triggered by pointer write to result register
+/// </summary>
+static void
+sim_start_conversion(hdc1000_sim_t *p_sim)
+{
+    uint16_t config = p_sim->config_reg;
+    uint32_t duration = 0;
+
+    if (config & HDC1000_SIM_CFG_MODE)
+    {
+        // Temperature and humidity are acquired in sequence
+        p_sim->conv_regs = CONV_TEMP | CONV_HUMI;
+    }
+    else
+    {
+        p_sim->conv_regs = (p_sim->pointer == HDC1000_REG_TEMP) ?
+            CONV_TEMP : CONV_HUMI;
+    }
+
+    if (p_sim->conv_regs & CONV_TEMP)
+    {
+        duration += (config & HDC1000_SIM_CFG_TRES) ? 
+            HDC1000_CONV_TIME_TEMP_11BIT : HDC1000_CONV_TIME_TEMP_14BIT;
+    }
+    if (p_sim->conv_regs & CONV_HUMI)
+    {
+        switch ((config & HDC1000_SIM_CFG_HRES) >> 8)
+        {
+        case HDC1000_CFG_HUMI_11BIT:
+            duration += HDC1000_CONV_TIME_HUMI_11BIT;
+            break;
+        case HDC1000_CFG_HUMI_8BIT:
+            duration += HDC1000_CONV_TIME_HUMI_8BIT;
+            break;
+        default:
+            duration += HDC1000_CONV_TIME_HUMI_14BIT;
+            break;
+        }
+    }
+
+    // Battery status is updated after each measurement request
+    if (p_sim->vdd < BTST_THRESHOLD_V)
+    {
+        p_sim->config_reg |= HDC1000_SIM_CFG_BTST;
+    }
+    else
+    {
+        p_sim->config_reg &= (uint16_t)~HDC1000_SIM_CFG_BTST;
+    }
+
+    p_sim->conv_start_us = p_sim->now_us;
+    p_sim->conv_end_us = p_sim->now_us + duration;
+}
+
+/// <summary>
+///		Store conversion results to result registers
+/// </summary>
+static void
+sim_latch_results(hdc1000_sim_t *p_sim)
+{
+    double temp = p_sim->ambient_temp + p_sim->heater_rise;
+    double humi = p_sim->ambient_humi / 
+        (1.0 + HEATER_RH_FACTOR * p_sim->heater_rise);
+    double code;
+
+    if (p_sim->conv_regs & CONV_TEMP)
+    {
+        code = (temp + 40.0) / 165.0 * 65536.0 + 0.5;
+        code = (code < 0.0) ? 0.0 : (code > 65535.0) ? 65535.0 : code;
+        p_sim->temp_reg = (uint16_t)code & 
+            sim_result_mask(p_sim->config_reg, HDC1000_REG_TEMP);
+    }
+
+    if (p_sim->conv_regs & CONV_HUMI)
+    {
+        code = humi / 100.0 * 65536.0 + 0.5;
+        code = (code < 0.0) ? 0.0 : (code > 65535.0) ? 65535.0 : code;
+        p_sim->humi_reg = (uint16_t)code & 
+            sim_result_mask(p_sim->config_reg, HDC1000_REG_HUMI);
+    }
+
+    p_sim->conv_regs = 0;
+}
+
+/// <summary>
+///		Get mask of result bits at configured resolution
+/// <para>Results are left aligned, unused low bits read as 0: 2 bits at
+/// 14-bit, 5 bits at 11-bit and 8 bits at 8-bit resolution.</para>
+/// </summary>
+static uint16_t
+sim_result_mask(uint16_t config, uint8_t reg_addr)
+{
+    if (reg_addr == HDC1000_REG_TEMP)
+    {
+        return (config & HDC1000_SIM_CFG_TRES) ? 0xFFE0 : 0xFFFC;
+    }
+
+    switch ((config & HDC1000_SIM_CFG_HRES) >> 8)
+    {
+    case HDC1000_CFG_HUMI_11BIT:
+        return 0xFFE0;
+    case HDC1000_CFG_HUMI_8BIT:
+        return 0xFF00;
+    default:
+        return 0xFFFC;
+    }
+}
+
+/// <summary>
+///		Get register value addressed by pointer
+/// </summary>
+static uint16_t
+sim_reg_value(hdc1000_sim_t *p_sim, uint8_t reg_addr)
+{
+    switch (reg_addr)
+    {
+    case HDC1000_REG_TEMP:
+        return p_sim->temp_reg;
+    case HDC1000_REG_HUMI:
+        return p_sim->humi_reg;
+    case HDC1000_REG_CONFIG:
+        return p_sim->config_reg;
+    case HDC1000_REG_SERID_1:
+        return p_sim->serid[0];
+    case HDC1000_REG_SERID_2:
+        return p_sim->serid[1];
+    case HDC1000_REG_SERID_3:
+        return p_sim->serid[2];
+    case HDC1000_REG_MFID:
+        return HDC1000_SIM_MFID;
+    case HDC1000_REG_DEVID:
+        return HDC1000_SIM_DEVID;
+    default:
+        return 0xFFFF;
+    }
+}
+
+/* [] END OF FILE */
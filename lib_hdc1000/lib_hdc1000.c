@@ -58,6 +58,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <time.h>
+#include <sys/timerfd.h>
 
 #include <applibs/log.h>
 #include <applibs/i2c.h>
@@ -65,25 +66,127 @@
 
 #include "lib_hdc1000.h"
 
+/*******************************************************************************
+* Types
+*******************************************************************************/
+
+// Per-device platform data, stored in hdc1000_t user_data
+typedef struct
+{
+    int i2c_fd;                 // I2C file descriptor
+    int gpio_fd;                // DRDYn GPIO file descriptor
+    int timer_fd;               // Measurement ready timer file descriptor
+    uint32_t write_delay_us;    // Delay before each I2C write
+    hdc1000_ready_cb ready_cb;  // Measurement completion cb
+    void *ready_context;        // Completion cb context
+} hdc1000_platform_t;
+
+#define PLATFORM(p_hdc)     ((hdc1000_platform_t *)(p_hdc)->user_data)
+
+// Platform callback has external linkage when the driver is built with
+// -DHDC1000_PLATFORM_CB=hdc1000_platform_cb
+#ifdef HDC1000_PLATFORM_CB
+#define PLATFORM_CB_SCOPE
+#else
+#define PLATFORM_CB_SCOPE   static
+#endif
+
+// Timer recheck interval if DRDYn is still high after conversion time
+#define DRDYN_RECHECK_US    200
+
+/*******************************************************************************
+ * Global variables
+ *******************************************************************************/
+
+// hdc1000_t itself comes from the driver pool, see hdc1000_init_user()
+#if HDC1000_POOL_SIZE > 0
+static hdc1000_platform_t platform_pool[HDC1000_POOL_SIZE];
+static uint8_t platform_pool_used[HDC1000_POOL_SIZE];
+#endif
+
  /*******************************************************************************
  * Forward declarations of private functions
  *******************************************************************************/
 
+/// <summary>
+///     Get per-device platform data from static pool or heap
+/// </summary>
+/// <returns>Zeroed platform data or NULL if exhausted</returns>
+static hdc1000_platform_t
+*hdc1000_platform_alloc(void);
+
+/// <summary>
+///     Return platform data taken by hdc1000_platform_alloc()
+/// </summary>
+/// <param name="p_platform">Pointer to per-device platform data</param>
+static void
+hdc1000_platform_free(hdc1000_platform_t *p_platform);
+
  /// <summary>
  ///     Platform dependent implementation of the delay and gpio callback
  /// </summary>
  /// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
  /// <returns></returns>
-static int
+PLATFORM_CB_SCOPE int
 hdc1000_platform_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int,
     void *arg_ptr);
 
-/*******************************************************************************
-* Global variables
-*******************************************************************************/
+/// <summary>
+///     Write bytes to HDC1000 in one I2C transaction
+/// <para>Performs configured OS 19.11 workaround delay first.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="data">Data to be written</param>
+/// <param name="length">Number of bytes</param>
+/// <returns>1 on success, -1 on failure</returns>
+static int
+hdc1000_i2c_write(hdc1000_t *p_hdc, const uint8_t *data, size_t length);
+
+/// <summary>
+///     Read bytes from HDC1000 in one I2C transaction
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="buffer">Read buffer</param>
+/// <param name="length">Number of bytes</param>
+/// <returns>1 on success, -1 on failure or short read</returns>
+static int
+hdc1000_i2c_read(hdc1000_t *p_hdc, uint8_t *buffer, size_t length);
+
+/// <summary>
+///     Write bytes and read the response with repeated start in between
+/// <para>Performs configured OS 19.11 workaround delay first.</para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="data">Data to be written</param>
+/// <param name="data_len">Number of bytes to write</param>
+/// <param name="buffer">Read buffer</param>
+/// <param name="length">Number of bytes to read</param>
+/// <returns>1 on success, -1 on failure or short read</returns>
+static int
+hdc1000_i2c_write_read(hdc1000_t *p_hdc, const uint8_t *data,
+    size_t data_len, uint8_t *buffer, size_t length);
+
+/// <summary>
+///     Run segments of HDC1000_MSG_TRANSACTION
+/// <para>DRDYn wait is not supported, see HDC1000_MSG_GPIO_WAIT_FALLING.
+/// </para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="segs">Segments to run in order</param>
+/// <param name="count">Number of segments</param>
+/// <returns>1 on success, HDC1000_CB_* on failure</returns>
+static int
+hdc1000_transaction(hdc1000_t *p_hdc, hdc1000_segment_t *segs,
+    uint8_t count);
 
-static int i2cFd = -1;      // Global I2C file descriptor
-static int gpioFd = -1;     // Global GPIO file descriptor
+/// <summary>
+///     Arm measurement timer to expire after given time
+/// </summary>
+/// <param name="p_platform">Pointer to per-device platform data</param>
+/// <param name="usec">Time in microseconds</param>
+/// <returns>0 on success, -1 on failure</returns>
+static int
+hdc1000_arm_timer(hdc1000_platform_t *p_platform, uint32_t usec);
 
 /*******************************************************************************
 * Function definitions
@@ -92,54 +195,186 @@ static int gpioFd = -1;     // Global GPIO file descriptor
 hdc1000_t
 *hdc1000_open(int i2c_fd, I2C_DeviceAddress i2c_addr, int drdyn_pin)
 {
-    i2cFd = i2c_fd;
-    return hdc1000_init((uint8_t)i2c_addr, drdyn_pin, hdc1000_platform_cb);
+    hdc1000_platform_t *p_platform;
+    hdc1000_t *p_hdc;
+
+    p_platform = hdc1000_platform_alloc();
+    if (p_platform == NULL)
+    {
+        return NULL;
+    }
+
+    p_platform->i2c_fd = i2c_fd;
+    p_platform->gpio_fd = -1;
+    p_platform->write_delay_us = HDC1000_WRITE_DELAY_US;
+
+    p_platform->timer_fd = timerfd_create(CLOCK_MONOTONIC,
+        TFD_NONBLOCK | TFD_CLOEXEC);
+    if (p_platform->timer_fd == -1)
+    {
+        Log_Debug("ERROR: timerfd_create: errno=%d (%s)\n", errno,
+            strerror(errno));
+    }
+
+    p_hdc = hdc1000_init_user((uint8_t)i2c_addr, drdyn_pin,
+        hdc1000_platform_cb, p_platform);
+    if (p_hdc == NULL)
+    {
+        if (p_platform->timer_fd != -1)
+        {
+            close(p_platform->timer_fd);
+        }
+        hdc1000_platform_free(p_platform);
+    }
+    else
+    {
+        hdc1000_set_transaction(p_hdc, 1);
+    }
+
+    return p_hdc;
 }
 
 void
 hdc1000_close(hdc1000_t *p_hdc)
 {
-    if (gpioFd != -1)
+    hdc1000_platform_t *p_platform;
+
+    // Failed hdc1000_open() returned NULL
+    if (p_hdc == NULL)
+    {
+        return;
+    }
+    p_platform = PLATFORM(p_hdc);
+
+    if (p_platform->gpio_fd != -1)
+    {
+        close(p_platform->gpio_fd);
+    }
+
+    if (p_platform->timer_fd != -1)
     {
-        close(gpioFd);
+        close(p_platform->timer_fd);
     }
 
     hdc1000_shutdown(p_hdc);
+    hdc1000_platform_free(p_platform);
 }
 
-static int
+void
+hdc1000_set_write_delay(hdc1000_t *p_hdc, uint32_t usec)
+{
+    PLATFORM(p_hdc)->write_delay_us = usec;
+}
+
+int
+hdc1000_async_get_fd(hdc1000_t *p_hdc)
+{
+    return PLATFORM(p_hdc)->timer_fd;
+}
+
+int
+hdc1000_async_start(hdc1000_t *p_hdc, uint8_t reg_addr,
+    hdc1000_ready_cb ready_cb, void *context)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+    int conv_time;
+
+    if (p_platform->timer_fd == -1)
+    {
+        return -1;
+    }
+
+    p_platform->ready_cb = ready_cb;
+    p_platform->ready_context = context;
+
+    conv_time = hdc1000_start_measurement(p_hdc, reg_addr);
+    if (conv_time < 0)
+    {
+        return -1;
+    }
+    return hdc1000_arm_timer(p_platform, (uint32_t)conv_time);
+}
+
+int
+hdc1000_async_handle_event(hdc1000_t *p_hdc)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+    uint64_t expirations;
+    uint32_t remaining_us;
+    uint16_t temp_raw = 0;
+    uint16_t humi_raw = 0;
+    int state;
+    int result;
+
+    // Consume timer expiration so that descriptor is no longer readable
+    if (read(p_platform->timer_fd, &expirations, sizeof(expirations)) == -1
+        && errno != EAGAIN)
+    {
+        Log_Debug("ERROR: read timerfd: errno=%d (%s)\n", errno,
+            strerror(errno));
+        return -1;
+    }
+
+    state = hdc1000_poll(p_hdc, &remaining_us);
+    if (state == HDC1000_STATE_IDLE)
+    {
+        return 0;
+    }
+
+    if (state == HDC1000_STATE_BUSY)
+    {
+        // DRDYn still high or timer fired early, check again later
+        return hdc1000_arm_timer(p_platform, (remaining_us > 0) ?
+            remaining_us : DRDYN_RECHECK_US);
+    }
+
+    if (state == HDC1000_STATE_READY)
+    {
+        result = hdc1000_fetch(p_hdc, &temp_raw, &humi_raw);
+    }
+    else
+    {
+        // DRDYn timed out or could not be read, measurement is abandoned
+        result = state;
+    }
+
+    if (p_platform->ready_cb != NULL)
+    {
+        (*p_platform->ready_cb)(p_hdc, result, temp_raw, humi_raw,
+            p_platform->ready_context);
+    }
+    return 1;
+}
+
+PLATFORM_CB_SCOPE int
 hdc1000_platform_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int,
     void *arg_ptr)
 {
 
     struct timespec sleepTime;
-    ssize_t result = 0;
 
     switch (msg)
     {
     case HDC1000_MSG_I2C_READ_BYTES:
         // Read arg_int bytes from I2C address and store it to arg_ptr
-        result = I2CMaster_Read(i2cFd, p_hdc->i2c_addr, arg_ptr, arg_int);
-        if (result == -1)
+        if (hdc1000_i2c_read(p_hdc, arg_ptr, arg_int) == -1)
         {
-            Log_Debug("ERROR: I2CMaster_Read: errno=%d (%s)\n", errno,
-                strerror(errno));
             return -1;
         }
         break;
 
     case HDC1000_MSG_I2C_WRITE_BYTE:
-        // OS 19.11 workaround delay
-        sleepTime.tv_sec = 0;
-        sleepTime.tv_nsec = 800000;
-        nanosleep(&sleepTime, NULL);
-
         // Write 1 byte from arg_int to I2C address
-        result = I2CMaster_Write(i2cFd, p_hdc->i2c_addr, &arg_int, 1);
-        if (result == -1)
+        if (hdc1000_i2c_write(p_hdc, &arg_int, 1) == -1)
+        {
+            return -1;
+        }
+        break;
+
+    case HDC1000_MSG_I2C_WRITE_BYTES:
+        // Write arg_int bytes from arg_ptr to I2C address
+        if (hdc1000_i2c_write(p_hdc, arg_ptr, arg_int) == -1)
         {
-            Log_Debug("ERROR: I2CMaster_Write: errno=%d (%s)\n", errno,
-                strerror(errno));
             return -1;
         }
         break;
@@ -148,36 +383,248 @@ hdc1000_platform_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int,
         // Perform delay for arg_int milliseconds
         sleepTime.tv_sec = 0;
         sleepTime.tv_nsec = 1000000 * arg_int;
-        result = nanosleep(&sleepTime, NULL);
+        nanosleep(&sleepTime, NULL);
+        break;
+
+    case HDC1000_MSG_DELAY_MICRO:
+        // Perform delay for *arg_ptr microseconds
+        sleepTime.tv_sec = *(uint32_t *)arg_ptr / 1000000;
+        sleepTime.tv_nsec = (*(uint32_t *)arg_ptr % 1000000) * 1000;
+        nanosleep(&sleepTime, NULL);
+        break;
+
+    case HDC1000_MSG_GET_TIME_MICRO:
+        // Store monotonic time in microseconds to *arg_ptr
+        clock_gettime(CLOCK_MONOTONIC, &sleepTime);
+        *(uint64_t *)arg_ptr = (uint64_t)sleepTime.tv_sec * 1000000 +
+            (uint64_t)sleepTime.tv_nsec / 1000;
         break;
 
     case HDC1000_MSG_GPIO_MODE_INPUT:
         // Open a GPIO as an input
         // arg_int should contain DRDYn signal GPIO pin number
-        gpioFd = GPIO_OpenAsInput((GPIO_Id)arg_int);
-        if (gpioFd == -1)
+        PLATFORM(p_hdc)->gpio_fd = GPIO_OpenAsInput((GPIO_Id)arg_int);
+        if (PLATFORM(p_hdc)->gpio_fd == -1)
         {
             Log_Debug("ERROR: GPIO_OpenAsInput: errno=%d (%s)\n", errno,
                 strerror(errno));
-            result = -1;
+            return HDC1000_CB_ERROR;
         }
         break;
 
     case HDC1000_MSG_GPIO_GET_VALUE:
         // Gets the current value of a GPIO
-        result = GPIO_GetValue(gpioFd, arg_ptr);
-        if (result == -1)
+        if (GPIO_GetValue(PLATFORM(p_hdc)->gpio_fd, arg_ptr) == -1)
         {
             Log_Debug("ERROR: GPIO_GetValue: errno=%d (%s)\n", errno,
                 strerror(errno));
+            return HDC1000_CB_ERROR;
         }
         break;
 
+    case HDC1000_MSG_TRANSACTION:
+        // Run arg_int segments from arg_ptr in this callback
+        return hdc1000_transaction(p_hdc, arg_ptr, arg_int);
+
     default:
-        break;
+        // Includes HDC1000_MSG_GPIO_WAIT_FALLING, applibs GPIO provides
+        // no edge events and the driver falls back to polling, and
+        // HDC1000_MSG_I2C_RECOVER, bus recovery is up to the OS
+        return HDC1000_CB_UNSUPPORTED;
+    }
+
+    return HDC1000_CB_OK;
+}
+
+static int
+hdc1000_i2c_write(hdc1000_t *p_hdc, const uint8_t *data, size_t length)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+    struct timespec sleepTime;
+    ssize_t result;
+
+    if (p_platform->write_delay_us > 0)
+    {
+        sleepTime.tv_sec = p_platform->write_delay_us / 1000000;
+        sleepTime.tv_nsec = (p_platform->write_delay_us % 1000000) * 1000;
+        nanosleep(&sleepTime, NULL);
+    }
+
+    result = I2CMaster_Write(p_platform->i2c_fd, p_hdc->i2c_addr, data,
+        length);
+    if (result == -1)
+    {
+        Log_Debug("ERROR: I2CMaster_Write: errno=%d (%s)\n", errno,
+            strerror(errno));
+        return -1;
     }
+    return 1;
+}
+
+static int
+hdc1000_i2c_read(hdc1000_t *p_hdc, uint8_t *buffer, size_t length)
+{
+    ssize_t result;
 
+    result = I2CMaster_Read(PLATFORM(p_hdc)->i2c_fd, p_hdc->i2c_addr, buffer,
+        length);
+    if (result == -1)
+    {
+        Log_Debug("ERROR: I2CMaster_Read: errno=%d (%s)\n", errno,
+            strerror(errno));
+        return -1;
+    }
+    if ((size_t)result != length)
+    {
+        // Short read leaves part of the buffer undefined
+        Log_Debug("ERROR: I2CMaster_Read: %d of %u bytes\n", (int)result,
+            (unsigned)length);
+        return -1;
+    }
+    return 1;
+}
+
+static int
+hdc1000_i2c_write_read(hdc1000_t *p_hdc, const uint8_t *data,
+    size_t data_len, uint8_t *buffer, size_t length)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+    struct timespec sleepTime;
+    ssize_t result;
+
+    if (p_platform->write_delay_us > 0)
+    {
+        sleepTime.tv_sec = p_platform->write_delay_us / 1000000;
+        sleepTime.tv_nsec = (p_platform->write_delay_us % 1000000) * 1000;
+        nanosleep(&sleepTime, NULL);
+    }
+
+    result = I2CMaster_WriteThenRead(p_platform->i2c_fd, p_hdc->i2c_addr,
+        data, data_len, buffer, length);
+    if (result == -1)
+    {
+        Log_Debug("ERROR: I2CMaster_WriteThenRead: errno=%d (%s)\n", errno,
+            strerror(errno));
+        return -1;
+    }
+    if ((size_t)result != data_len + length)
+    {
+        Log_Debug("ERROR: I2CMaster_WriteThenRead: %d of %u bytes\n",
+            (int)result, (unsigned)(data_len + length));
+        return -1;
+    }
     return 1;
 }
 
+static int
+hdc1000_transaction(hdc1000_t *p_hdc, hdc1000_segment_t *segs,
+    uint8_t count)
+{
+    struct timespec sleepTime;
+    int result = 1;
+    uint8_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (segs[i].type > HDC1000_SEG_DELAY)
+        {
+            return HDC1000_CB_UNSUPPORTED;
+        }
+    }
+
+    for (i = 0; i < count && result > 0; i++)
+    {
+        switch (segs[i].type)
+        {
+        case HDC1000_SEG_WRITE:
+            if (i + 1 < count && segs[i + 1].type == HDC1000_SEG_READ)
+            {
+                // Pointer write and read without stop in between
+                result = hdc1000_i2c_write_read(p_hdc, segs[i].data,
+                    segs[i].length, segs[i + 1].data, segs[i + 1].length);
+                i++;
+            }
+            else
+            {
+                result = hdc1000_i2c_write(p_hdc, segs[i].data,
+                    segs[i].length);
+            }
+            break;
+
+        case HDC1000_SEG_READ:
+            result = hdc1000_i2c_read(p_hdc, segs[i].data, segs[i].length);
+            break;
+
+        case HDC1000_SEG_DELAY:
+            sleepTime.tv_sec = segs[i].usec / 1000000;
+            sleepTime.tv_nsec = (segs[i].usec % 1000000) * 1000;
+            nanosleep(&sleepTime, NULL);
+            break;
+        }
+    }
+
+    return (result == -1) ? HDC1000_CB_ERROR : HDC1000_CB_OK;
+}
+
+static int
+hdc1000_arm_timer(hdc1000_platform_t *p_platform, uint32_t usec)
+{
+    struct itimerspec timerSpec;
+
+    // Zero it_value would disarm the timer, fire as soon as possible
+    if (usec == 0)
+    {
+        usec = 1;
+    }
+
+    memset(&timerSpec, 0, sizeof(timerSpec));
+    timerSpec.it_value.tv_sec = usec / 1000000;
+    timerSpec.it_value.tv_nsec = (usec % 1000000) * 1000;
+
+    if (timerfd_settime(p_platform->timer_fd, 0, &timerSpec, NULL) == -1)
+    {
+        Log_Debug("ERROR: timerfd_settime: errno=%d (%s)\n", errno,
+            strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static hdc1000_platform_t
+*hdc1000_platform_alloc(void)
+{
+    hdc1000_platform_t *p_platform = NULL;
+#if HDC1000_POOL_SIZE > 0
+    size_t i;
+
+    for (i = 0; i < HDC1000_POOL_SIZE; i++)
+    {
+        if (!platform_pool_used[i])
+        {
+            platform_pool_used[i] = 1;
+            p_platform = &platform_pool[i];
+            break;
+        }
+    }
+#else
+    p_platform = (hdc1000_platform_t *)malloc(sizeof(hdc1000_platform_t));
+#endif
+
+    if (p_platform != NULL)
+    {
+        memset(p_platform, 0, sizeof(hdc1000_platform_t));
+    }
+    return p_platform;
+}
+
+static void
+hdc1000_platform_free(hdc1000_platform_t *p_platform)
+{
+#if HDC1000_POOL_SIZE > 0
+    platform_pool_used[p_platform - platform_pool] = 0;
+#else
+    free(p_platform);
+#endif
+}
+
 /* [] END OF FILE */
@@ -0,0 +1,809 @@
+/*
+ * Driver HDC1000 digital temperature and humidity sensor used with Linux
+ * i2c-dev and GPIO character device interfaces.
+ *
+ * This source code file is a platform dependent part of HDC1000 driver.
+ *
+ * ---------------------------------------------------------------------------
+ *
+ * The BSD License (3-clause license)
+ *
+ * Copyright (c) 2019 Jaroslav Groman (https://github.com/jgroman)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ /***************************************************************************//**
+ * @file    lib_hdc1000_linux.c
+ * @version 1.0.0
+ *
+ * @brief Definitions for HDC1000 Linux platform dependent wrapper.
+ *
+ * @par Target device
+ *    HDC1000
+ *
+ * @par Description
+ *    A single byte write (register pointer) is held back and sent together
+ *    with a directly following read as one I2C_RDWR ioctl with repeated
+ *    start. Any other platform message sends the pending write first, so
+ *    bus operations keep their order relative to delays and DRDYn waits,
+ *    and fails with HDC1000_CB_ERROR if that write is not acknowledged.
+ *    The driver checks every message following a write for this.
+ *
+ * @author
+ *
+ * @date
+ *
+ *******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+
+#include <linux/gpio.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#include "lib_hdc1000_linux.h"
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+
+// Per-device platform data, stored in hdc1000_t user_data
+typedef struct
+{
+    int i2c_fd;                 // I2C bus file descriptor
+    int event_fd;               // DRDYn line event file descriptor
+    int timer_fd;               // Measurement ready timer file descriptor
+    const char *gpiochip_dev;   // GPIO chip device path
+    uint8_t pending;            // Deferred write byte
+    uint8_t pending_len;        // Number of deferred write bytes, 0 or 1
+    hdc1000_ready_cb ready_cb;  // Measurement completion cb
+    void *ready_context;        // Completion cb context
+} hdc1000_platform_t;
+
+#define PLATFORM(p_hdc)     ((hdc1000_platform_t *)(p_hdc)->user_data)
+
+// Platform callback has external linkage when the driver is built with
+// -DHDC1000_PLATFORM_CB=hdc1000_platform_cb
+#ifdef HDC1000_PLATFORM_CB
+#define PLATFORM_CB_SCOPE
+#else
+#define PLATFORM_CB_SCOPE   static
+#endif
+
+// Timer recheck interval if DRDYn is still high after conversion time
+#define DRDYN_RECHECK_US    200
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+
+// hdc1000_t itself comes from the driver pool, see hdc1000_init_user()
+#if HDC1000_POOL_SIZE > 0
+static hdc1000_platform_t platform_pool[HDC1000_POOL_SIZE];
+static uint8_t platform_pool_used[HDC1000_POOL_SIZE];
+#endif
+
+/*******************************************************************************
+* Forward declarations of private functions
+*******************************************************************************/
+
+/// <summary>
+///     Get per-device platform data from static pool or heap
+/// </summary>
+/// <returns>Zeroed platform data or NULL if exhausted</returns>
+static hdc1000_platform_t
+*hdc1000_platform_alloc(void);
+
+/// <summary>
+///     Return platform data taken by hdc1000_platform_alloc()
+/// </summary>
+/// <param name="p_platform">Pointer to per-device platform data</param>
+static void
+hdc1000_platform_free(hdc1000_platform_t *p_platform);
+
+/// <summary>
+///     Platform dependent implementation of the HDC1000 callback
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <returns>Non-negative on success, HDC1000_CB_* on failure</returns>
+PLATFORM_CB_SCOPE int
+hdc1000_platform_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int,
+    void *arg_ptr);
+
+/// <summary>
+///     Run I2C_RDWR ioctl with pending write byte followed by optional read
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="buffer">Read buffer or NULL</param>
+/// <param name="length">Number of bytes to read</param>
+/// <returns>0 on success, -1 on failure</returns>
+static int
+hdc1000_i2c_transfer(hdc1000_t *p_hdc, uint8_t *buffer, uint8_t length);
+
+/// <summary>
+///     Run I2C_RDWR ioctl with optional write followed by optional read
+/// <para>Both parts share one ioctl with repeated start in between.
+/// </para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="data">Data to be written or NULL</param>
+/// <param name="data_len">Number of bytes to write</param>
+/// <param name="buffer">Read buffer or NULL</param>
+/// <param name="length">Number of bytes to read</param>
+/// <returns>0 on success, -1 on failure</returns>
+static int
+hdc1000_i2c_write_read(hdc1000_t *p_hdc, uint8_t *data, uint8_t data_len,
+    uint8_t *buffer, uint8_t length);
+
+/// <summary>
+///     Run segments of HDC1000_MSG_TRANSACTION
+/// <para>Pointer write and directly following read are one I2C_RDWR.
+/// </para>
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="segs">Segments to run in order</param>
+/// <param name="count">Number of segments</param>
+/// <returns>0 on success, HDC1000_CB_* on failure</returns>
+static int
+hdc1000_transaction(hdc1000_t *p_hdc, hdc1000_segment_t *segs,
+    uint8_t count);
+
+/// <summary>
+///     Block until DRDYn falling edge or timeout
+/// </summary>
+/// <param name="p_platform">Pointer to per-device platform data</param>
+/// <param name="usec">Timeout in microseconds</param>
+/// <returns>0 on edge, HDC1000_CB_TIMEOUT or HDC1000_CB_ERROR</returns>
+static int
+hdc1000_wait_falling(hdc1000_platform_t *p_platform, uint32_t usec);
+
+/// <summary>
+///     Sleep for given time
+/// </summary>
+/// <param name="usec">Time in microseconds</param>
+static void
+hdc1000_sleep_us(uint32_t usec);
+
+/// <summary>
+///     Write bytes in one I2C transaction
+/// </summary>
+/// <param name="p_hdc">Pointer to hdc1000_t data struct</param>
+/// <param name="data">Data to be written</param>
+/// <param name="length">Number of bytes</param>
+/// <returns>0 on success, -1 on failure</returns>
+static int
+hdc1000_i2c_write(hdc1000_t *p_hdc, uint8_t *data, uint8_t length);
+
+/// <summary>
+///     Discard DRDYn edge events queued before current conversion
+/// </summary>
+/// <param name="p_platform">Pointer to per-device platform data</param>
+static void
+hdc1000_drain_events(hdc1000_platform_t *p_platform);
+
+/// <summary>
+///     Arm measurement timer to expire after given time
+/// </summary>
+/// <param name="p_platform">Pointer to per-device platform data</param>
+/// <param name="usec">Time in microseconds</param>
+/// <returns>0 on success, -1 on failure</returns>
+static int
+hdc1000_arm_timer(hdc1000_platform_t *p_platform, uint32_t usec);
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+hdc1000_t
+*hdc1000_linux_open(const char *i2c_dev, uint8_t i2c_addr,
+    const char *gpiochip_dev, int drdyn_line)
+{
+    hdc1000_platform_t *p_platform;
+    hdc1000_t *p_hdc;
+
+    p_platform = hdc1000_platform_alloc();
+    if (p_platform == NULL)
+    {
+        return NULL;
+    }
+
+    p_platform->event_fd = -1;
+    p_platform->gpiochip_dev = gpiochip_dev;
+
+    if (gpiochip_dev == NULL)
+    {
+        drdyn_line = -1;
+    }
+
+    p_platform->i2c_fd = open(i2c_dev, O_RDWR | O_CLOEXEC);
+    if (p_platform->i2c_fd == -1)
+    {
+        fprintf(stderr, "ERROR: open %s: errno=%d (%s)\n", i2c_dev, errno,
+            strerror(errno));
+        hdc1000_platform_free(p_platform);
+        return NULL;
+    }
+
+    p_platform->timer_fd = timerfd_create(CLOCK_MONOTONIC,
+        TFD_NONBLOCK | TFD_CLOEXEC);
+    if (p_platform->timer_fd == -1)
+    {
+        fprintf(stderr, "ERROR: timerfd_create: errno=%d (%s)\n", errno,
+            strerror(errno));
+    }
+
+    p_hdc = hdc1000_init_user(i2c_addr, drdyn_line, hdc1000_platform_cb,
+        p_platform);
+    if (p_hdc == NULL)
+    {
+        close(p_platform->i2c_fd);
+        if (p_platform->timer_fd != -1)
+        {
+            close(p_platform->timer_fd);
+        }
+        hdc1000_platform_free(p_platform);
+    }
+    else
+    {
+        hdc1000_set_transaction(p_hdc, 1);
+    }
+
+    return p_hdc;
+}
+
+void
+hdc1000_linux_close(hdc1000_t *p_hdc)
+{
+    hdc1000_platform_t *p_platform;
+
+    // Failed hdc1000_linux_open() returned NULL
+    if (p_hdc == NULL)
+    {
+        return;
+    }
+    p_platform = PLATFORM(p_hdc);
+
+    hdc1000_i2c_transfer(p_hdc, NULL, 0);
+
+    if (p_platform->event_fd != -1)
+    {
+        close(p_platform->event_fd);
+    }
+
+    if (p_platform->timer_fd != -1)
+    {
+        close(p_platform->timer_fd);
+    }
+
+    close(p_platform->i2c_fd);
+    hdc1000_shutdown(p_hdc);
+    hdc1000_platform_free(p_platform);
+}
+
+int
+hdc1000_async_get_fd(hdc1000_t *p_hdc)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+
+    // DRDYn line events signal completion directly, timer is a fallback
+    if (p_platform->event_fd != -1)
+    {
+        return p_platform->event_fd;
+    }
+    return p_platform->timer_fd;
+}
+
+int
+hdc1000_async_start(hdc1000_t *p_hdc, uint8_t reg_addr,
+    hdc1000_ready_cb ready_cb, void *context)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+    int conv_time;
+
+    if (hdc1000_async_get_fd(p_hdc) == -1)
+    {
+        return -1;
+    }
+
+    p_platform->ready_cb = ready_cb;
+    p_platform->ready_context = context;
+
+    conv_time = hdc1000_start_measurement(p_hdc, reg_addr);
+    if (conv_time < 0)
+    {
+        return -1;
+    }
+    if (p_platform->event_fd != -1)
+    {
+        return 0;
+    }
+    return hdc1000_arm_timer(p_platform, (uint32_t)conv_time);
+}
+
+int
+hdc1000_async_handle_event(hdc1000_t *p_hdc)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+    uint64_t expirations;
+    uint32_t remaining_us;
+    uint16_t temp_raw = 0;
+    uint16_t humi_raw = 0;
+    int state;
+    int result;
+
+    if (p_platform->event_fd != -1)
+    {
+        hdc1000_drain_events(p_platform);
+    }
+    else if (read(p_platform->timer_fd, &expirations, 
+        sizeof(expirations)) == -1 && errno != EAGAIN)
+    {
+        fprintf(stderr, "ERROR: read timerfd: errno=%d (%s)\n", errno,
+            strerror(errno));
+        return -1;
+    }
+
+    state = hdc1000_poll(p_hdc, &remaining_us);
+    if (state == HDC1000_STATE_IDLE)
+    {
+        return 0;
+    }
+
+    if (state == HDC1000_STATE_BUSY)
+    {
+        if (p_platform->event_fd != -1)
+        {
+            // Spurious event, wait for the next falling edge
+            return 0;
+        }
+        return hdc1000_arm_timer(p_platform, (remaining_us > 0) ?
+            remaining_us : DRDYN_RECHECK_US);
+    }
+
+    if (state == HDC1000_STATE_READY)
+    {
+        result = hdc1000_fetch(p_hdc, &temp_raw, &humi_raw);
+    }
+    else
+    {
+        // DRDYn timed out or could not be read, measurement is abandoned
+        result = state;
+    }
+
+    if (p_platform->ready_cb != NULL)
+    {
+        (*p_platform->ready_cb)(p_hdc, result, temp_raw, humi_raw,
+            p_platform->ready_context);
+    }
+    return 1;
+}
+
+PLATFORM_CB_SCOPE int
+hdc1000_platform_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int,
+    void *arg_ptr)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+    struct gpioevent_request event_req;
+    struct gpiohandle_data line_data;
+    struct timespec timeSpec;
+    int chip_fd;
+    int result = 0;
+
+    if (msg == HDC1000_MSG_I2C_WRITE_BYTE)
+    {
+        // Defer write, it may be combined with a following read
+        if (p_platform->pending_len > 0 &&
+            hdc1000_i2c_transfer(p_hdc, NULL, 0) == -1)
+        {
+            return HDC1000_CB_ERROR;
+        }
+        p_platform->pending = arg_int;
+        p_platform->pending_len = 1;
+        return 0;
+    }
+
+    if (msg == HDC1000_MSG_I2C_RECOVER)
+    {
+        // Adapter drivers recover the bus themselves, only forget the
+        // deferred write and edges of the failed access
+        p_platform->pending_len = 0;
+        if (p_platform->event_fd != -1)
+        {
+            hdc1000_drain_events(p_platform);
+        }
+        return 0;
+    }
+
+    if (msg == HDC1000_MSG_I2C_READ_BYTES)
+    {
+        // Pending pointer write and read share one I2C_RDWR call
+        result = hdc1000_i2c_transfer(p_hdc, arg_ptr, arg_int);
+        return (result == -1) ? HDC1000_CB_ERROR : 0;
+    }
+
+    // Everything else is ordered after pending write
+    if (p_platform->pending_len > 0 && 
+        hdc1000_i2c_transfer(p_hdc, NULL, 0) == -1)
+    {
+        return HDC1000_CB_ERROR;
+    }
+
+    switch (msg)
+    {
+    case HDC1000_MSG_I2C_WRITE_BYTES:
+        // Write arg_int bytes from arg_ptr as one transaction
+        if (hdc1000_i2c_write(p_hdc, arg_ptr, arg_int) == -1)
+        {
+            return HDC1000_CB_ERROR;
+        }
+        break;
+
+    case HDC1000_MSG_DELAY_MILLI:
+        // Perform delay for arg_int milliseconds
+        timeSpec.tv_sec = 0;
+        timeSpec.tv_nsec = 1000000L * arg_int;
+        nanosleep(&timeSpec, NULL);
+        break;
+
+    case HDC1000_MSG_DELAY_MICRO:
+        // Perform delay for *arg_ptr microseconds
+        hdc1000_sleep_us(*(uint32_t *)arg_ptr);
+        break;
+
+    case HDC1000_MSG_GET_TIME_MICRO:
+        // Store monotonic time in microseconds to *arg_ptr
+        clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+        *(uint64_t *)arg_ptr = (uint64_t)timeSpec.tv_sec * 1000000 +
+            (uint64_t)timeSpec.tv_nsec / 1000;
+        break;
+
+    case HDC1000_MSG_GPIO_MODE_INPUT:
+        // Request DRDYn line arg_int as input with falling edge events
+        chip_fd = open(p_platform->gpiochip_dev, O_RDWR | O_CLOEXEC);
+        if (chip_fd == -1)
+        {
+            fprintf(stderr, "ERROR: open %s: errno=%d (%s)\n",
+                p_platform->gpiochip_dev, errno, strerror(errno));
+            return HDC1000_CB_ERROR;
+        }
+
+        memset(&event_req, 0, sizeof(event_req));
+        event_req.lineoffset = arg_int;
+        event_req.handleflags = GPIOHANDLE_REQUEST_INPUT;
+        event_req.eventflags = GPIOEVENT_REQUEST_FALLING_EDGE;
+        strncpy(event_req.consumer_label, "hdc1000-drdyn",
+            sizeof(event_req.consumer_label) - 1);
+
+        result = ioctl(chip_fd, GPIO_GET_LINEEVENT_IOCTL, &event_req);
+        close(chip_fd);
+        if (result == -1)
+        {
+            fprintf(stderr, "ERROR: GPIO_GET_LINEEVENT_IOCTL: errno=%d (%s)\n",
+                errno, strerror(errno));
+            return HDC1000_CB_ERROR;
+        }
+
+        p_platform->event_fd = event_req.fd;
+        fcntl(p_platform->event_fd, F_SETFL, 
+            fcntl(p_platform->event_fd, F_GETFL) | O_NONBLOCK);
+        break;
+
+    case HDC1000_MSG_GPIO_GET_VALUE:
+        // Gets the current value of DRDYn line
+        if (ioctl(p_platform->event_fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL,
+            &line_data) == -1)
+        {
+            fprintf(stderr, "ERROR: GPIOHANDLE_GET_LINE_VALUES_IOCTL: "
+                "errno=%d (%s)\n", errno, strerror(errno));
+            return HDC1000_CB_ERROR;
+        }
+        *(uint8_t *)arg_ptr = line_data.values[0];
+        break;
+
+    case HDC1000_MSG_GPIO_WAIT_FALLING:
+        // Block until DRDYn falling edge or *arg_ptr microseconds timeout
+        return hdc1000_wait_falling(p_platform, *(uint32_t *)arg_ptr);
+
+    case HDC1000_MSG_TRANSACTION:
+        // Run arg_int segments from arg_ptr in this callback
+        return hdc1000_transaction(p_hdc, arg_ptr, arg_int);
+
+    default:
+        return HDC1000_CB_UNSUPPORTED;
+    }
+
+    return 0;
+}
+
+static int
+hdc1000_i2c_transfer(hdc1000_t *p_hdc, uint8_t *buffer, uint8_t length)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+    uint8_t pending_len = p_platform->pending_len;
+
+    p_platform->pending_len = 0;
+    return hdc1000_i2c_write_read(p_hdc, &p_platform->pending, pending_len,
+        buffer, length);
+}
+
+static int
+hdc1000_i2c_write_read(hdc1000_t *p_hdc, uint8_t *data, uint8_t data_len,
+    uint8_t *buffer, uint8_t length)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+    struct i2c_msg msgs[2];
+    struct i2c_rdwr_ioctl_data rdwr;
+
+    rdwr.msgs = msgs;
+    rdwr.nmsgs = 0;
+
+    if (data_len > 0)
+    {
+        // New conversion may start, forget edges of previous ones
+        if (p_platform->event_fd != -1)
+        {
+            hdc1000_drain_events(p_platform);
+        }
+
+        msgs[rdwr.nmsgs].addr = p_hdc->i2c_addr;
+        msgs[rdwr.nmsgs].flags = 0;
+        msgs[rdwr.nmsgs].len = data_len;
+        msgs[rdwr.nmsgs].buf = data;
+        rdwr.nmsgs++;
+    }
+
+    if (length > 0)
+    {
+        msgs[rdwr.nmsgs].addr = p_hdc->i2c_addr;
+        msgs[rdwr.nmsgs].flags = I2C_M_RD;
+        msgs[rdwr.nmsgs].len = length;
+        msgs[rdwr.nmsgs].buf = buffer;
+        rdwr.nmsgs++;
+    }
+
+    if (rdwr.nmsgs == 0)
+    {
+        return 0;
+    }
+
+    if (ioctl(p_platform->i2c_fd, I2C_RDWR, &rdwr) == -1)
+    {
+        fprintf(stderr, "ERROR: I2C_RDWR: errno=%d (%s)\n", errno,
+            strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static int
+hdc1000_i2c_write(hdc1000_t *p_hdc, uint8_t *data, uint8_t length)
+{
+    struct i2c_msg msg;
+    struct i2c_rdwr_ioctl_data rdwr;
+
+    msg.addr = p_hdc->i2c_addr;
+    msg.flags = 0;
+    msg.len = length;
+    msg.buf = data;
+    rdwr.msgs = &msg;
+    rdwr.nmsgs = 1;
+
+    if (ioctl(PLATFORM(p_hdc)->i2c_fd, I2C_RDWR, &rdwr) == -1)
+    {
+        fprintf(stderr, "ERROR: I2C_RDWR: errno=%d (%s)\n", errno,
+            strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static int
+hdc1000_transaction(hdc1000_t *p_hdc, hdc1000_segment_t *segs,
+    uint8_t count)
+{
+    hdc1000_platform_t *p_platform = PLATFORM(p_hdc);
+    int result = 0;
+    uint8_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (segs[i].type > HDC1000_SEG_WAIT_DRDYN ||
+            (segs[i].type == HDC1000_SEG_WAIT_DRDYN &&
+            p_platform->event_fd == -1))
+        {
+            return HDC1000_CB_UNSUPPORTED;
+        }
+    }
+
+    for (i = 0; i < count && result == 0; i++)
+    {
+        switch (segs[i].type)
+        {
+        case HDC1000_SEG_WRITE:
+            if (i + 1 < count && segs[i + 1].type == HDC1000_SEG_READ)
+            {
+                // Repeated start instead of stop between write and read
+                result = hdc1000_i2c_write_read(p_hdc, segs[i].data,
+                    segs[i].length, segs[i + 1].data, segs[i + 1].length);
+                i++;
+            }
+            else
+            {
+                result = hdc1000_i2c_write_read(p_hdc, segs[i].data,
+                    segs[i].length, NULL, 0);
+            }
+            break;
+
+        case HDC1000_SEG_READ:
+            result = hdc1000_i2c_write_read(p_hdc, NULL, 0, segs[i].data,
+                segs[i].length);
+            break;
+
+        case HDC1000_SEG_DELAY:
+            hdc1000_sleep_us(segs[i].usec);
+            break;
+
+        case HDC1000_SEG_WAIT_DRDYN:
+            result = hdc1000_wait_falling(p_platform, segs[i].usec);
+            break;
+        }
+    }
+
+    if (result == -1)
+    {
+        return HDC1000_CB_ERROR;
+    }
+    return result;
+}
+
+static int
+hdc1000_wait_falling(hdc1000_platform_t *p_platform, uint32_t usec)
+{
+    struct gpioevent_data event_data;
+    struct timespec timeSpec;
+    struct pollfd pollFd;
+    int result;
+
+    timeSpec.tv_sec = usec / 1000000;
+    timeSpec.tv_nsec = (usec % 1000000) * 1000L;
+    pollFd.fd = p_platform->event_fd;
+    pollFd.events = POLLIN;
+
+    do
+    {
+        result = ppoll(&pollFd, 1, &timeSpec, NULL);
+    } while (result == -1 && errno == EINTR);
+
+    if (result == 0)
+    {
+        return HDC1000_CB_TIMEOUT;
+    }
+    if (result == -1 ||
+        read(p_platform->event_fd, &event_data, sizeof(event_data)) == -1)
+    {
+        fprintf(stderr, "ERROR: DRDYn wait: errno=%d (%s)\n", errno,
+            strerror(errno));
+        return HDC1000_CB_ERROR;
+    }
+    return 0;
+}
+
+static void
+hdc1000_sleep_us(uint32_t usec)
+{
+    struct timespec timeSpec;
+
+    timeSpec.tv_sec = usec / 1000000;
+    timeSpec.tv_nsec = (usec % 1000000) * 1000L;
+    nanosleep(&timeSpec, NULL);
+}
+
+static void
+hdc1000_drain_events(hdc1000_platform_t *p_platform)
+{
+    struct gpioevent_data event_data;
+
+    while (read(p_platform->event_fd, &event_data, sizeof(event_data)) > 0)
+    {
+    }
+}
+
+static int
+hdc1000_arm_timer(hdc1000_platform_t *p_platform, uint32_t usec)
+{
+    struct itimerspec timerSpec;
+
+    // Zero it_value would disarm the timer, fire as soon as possible
+    if (usec == 0)
+    {
+        usec = 1;
+    }
+
+    memset(&timerSpec, 0, sizeof(timerSpec));
+    timerSpec.it_value.tv_sec = usec / 1000000;
+    timerSpec.it_value.tv_nsec = (usec % 1000000) * 1000L;
+
+    if (timerfd_settime(p_platform->timer_fd, 0, &timerSpec, NULL) == -1)
+    {
+        fprintf(stderr, "ERROR: timerfd_settime: errno=%d (%s)\n", errno,
+            strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static hdc1000_platform_t
+*hdc1000_platform_alloc(void)
+{
+    hdc1000_platform_t *p_platform = NULL;
+#if HDC1000_POOL_SIZE > 0
+    size_t i;
+
+    for (i = 0; i < HDC1000_POOL_SIZE; i++)
+    {
+        if (!platform_pool_used[i])
+        {
+            platform_pool_used[i] = 1;
+            p_platform = &platform_pool[i];
+            break;
+        }
+    }
+#else
+    p_platform = (hdc1000_platform_t *)malloc(sizeof(hdc1000_platform_t));
+#endif
+
+    if (p_platform != NULL)
+    {
+        memset(p_platform, 0, sizeof(hdc1000_platform_t));
+    }
+    return p_platform;
+}
+
+static void
+hdc1000_platform_free(hdc1000_platform_t *p_platform)
+{
+#if HDC1000_POOL_SIZE > 0
+    platform_pool_used[p_platform - platform_pool] = 0;
+#else
+    free(p_platform);
+#endif
+}
+
+/* [] END OF FILE */
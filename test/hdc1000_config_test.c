@@ -0,0 +1,177 @@
+/***************************************************************************//**
+* @file    hdc1000_config_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 configuration register access.
+*
+* @par Description
+*    Writes configuration register as one multi-byte transfer and, on
+*    platforms without it, as single bytes verified by reading back.
+*    Checks the shadow register and the battery status cache.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Helpers
+*******************************************************************************/
+
+/// <summary>
+///     Baseline callback sending consecutive single byte writes as one
+///     transfer
+/// </summary>
+static int
+coalescing_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    static uint8_t pending[4];
+    static uint8_t pending_len;
+    int result = 0;
+
+    if (msg == HDC1000_MSG_I2C_WRITE_BYTE && pending_len < sizeof(pending))
+    {
+        pending[pending_len++] = arg_int;
+        return 1;
+    }
+    if (pending_len > 0)
+    {
+        result = hdc1000_sim_cb(p_hdc, HDC1000_MSG_I2C_WRITE_BYTES,
+            pending_len, pending);
+        pending_len = 0;
+    }
+    if (result < 0)
+    {
+        return -1;
+    }
+    return baseline_cb(p_hdc, msg, arg_int, arg_ptr);
+}
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_config_write(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+
+    // Pointer and both register bytes go in one transfer
+    hdc1000_set_transaction(p_hdc, 0);
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_set_config(p_hdc, 0, HDC1000_CFG_SINGLE_MEASUR,
+        HDC1000_CFG_HUMI_8BIT, HDC1000_CFG_HEAT_ON) == HDC1000_OK);
+    CHECK(sim.transactions == 1);
+    CHECK(sim.msg_count == 1);
+    CHECK((sim.config_reg >> 8) ==
+        (HDC1000_CFG_HUMI_8BIT | HDC1000_CFG_HEAT_ON));
+    CHECK(p_hdc->config == (HDC1000_CFG_HUMI_8BIT | HDC1000_CFG_HEAT_ON));
+
+    // Failed write leaves shadow unchanged
+    hdc1000_set_retry(p_hdc, 0, 0);
+    sim.fail_next = 1;
+    CHECK(hdc1000_set_heater(p_hdc, HDC1000_CFG_HEAT_OFF) == HDC1000_ERR_IO);
+    CHECK(p_hdc->config == (HDC1000_CFG_HUMI_8BIT | HDC1000_CFG_HEAT_ON));
+    CHECK(hdc1000_set_heater(p_hdc, HDC1000_CFG_HEAT_OFF) == 1);
+    CHECK((sim.config_reg >> 8) == HDC1000_CFG_HUMI_8BIT);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_config_fallback(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc;
+
+    // Single byte configuration writes are checked by reading them back
+    init_sim(&sim);
+    p_hdc = hdc1000_init_user(sim.i2c_addr, -1, baseline_cb, &sim);
+    CHECK(hdc1000_set_mode(p_hdc, HDC1000_CFG_SINGLE_MEASUR) ==
+        HDC1000_ERR_IO);
+    CHECK(p_hdc->config == HDC1000_CFG_DEFAULT);
+    CHECK(hdc1000_set_config(p_hdc, 0, HDC1000_CFG_BOTH_TEMP_HUMI, 0,
+        HDC1000_CFG_HEAT_ON) == HDC1000_ERR_IO);
+    CHECK(p_hdc->config == HDC1000_CFG_DEFAULT);
+    hdc1000_shutdown(p_hdc);
+
+    p_hdc = hdc1000_init_user(sim.i2c_addr, -1, coalescing_cb, &sim);
+    CHECK(hdc1000_set_config(p_hdc, 0, HDC1000_CFG_SINGLE_MEASUR,
+        HDC1000_CFG_TEMP_11BIT, HDC1000_CFG_HEAT_OFF) == HDC1000_OK);
+    CHECK(p_hdc->config == HDC1000_CFG_TEMP_11BIT);
+    CHECK((sim.config_reg >> 8) == HDC1000_CFG_TEMP_11BIT);
+    hdc1000_shutdown(p_hdc);
+}
+
+static void
+test_shadow(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    uint8_t btst = 0xFF;
+    int16_t temp;
+
+    // Unchanged settings are not written
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_set_heater(p_hdc, HDC1000_CFG_HEAT_OFF) == 0);
+    CHECK(hdc1000_set_mode(p_hdc, HDC1000_CFG_BOTH_TEMP_HUMI) == 0);
+    CHECK(sim.msg_count == 0);
+
+    // Battery status is read from the device by default
+    sim.vdd = 2.5;
+    CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_OK);
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_read_battery_status(p_hdc, &btst) == HDC1000_OK);
+    CHECK(btst == 1);
+    CHECK(sim.transactions > 0);
+
+    // Cached status is used until it is older than max age
+    hdc1000_set_btst_max_age(p_hdc, 100000);
+    sim.vdd = 3.3;
+    CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_OK);
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_get_battery_status(p_hdc) == 1);
+    CHECK(sim.transactions == 0);
+    hdc1000_sim_advance(&sim, 100000);
+    CHECK(hdc1000_get_battery_status(p_hdc) == 0);
+    CHECK(sim.transactions > 0);
+
+    // Failed read is reported, output is unchanged
+    hdc1000_set_btst_max_age(p_hdc, 0);
+    hdc1000_set_retry(p_hdc, 0, 0);
+    sim.fail_next = 1;
+    btst = 0xFF;
+    CHECK(hdc1000_read_battery_status(p_hdc, &btst) == HDC1000_ERR_IO);
+    CHECK(btst == 0xFF);
+
+    hdc1000_sim_close(p_hdc);
+
+    // Without a clock the cache age is unknown, status is always read
+    init_sim(&sim);
+    p_hdc = hdc1000_init_user(sim.i2c_addr, -1, baseline_cb, &sim);
+    hdc1000_set_btst_max_age(p_hdc, 1000000);
+    CHECK(hdc1000_read_battery_status(p_hdc, &btst) == HDC1000_OK);
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_read_battery_status(p_hdc, &btst) == HDC1000_OK);
+    CHECK(sim.transactions > 0);
+    hdc1000_shutdown(p_hdc);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_config_write();
+    test_config_fallback();
+    test_shadow();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,99 @@
+/***************************************************************************//**
+* @file    hdc1000_convert_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 register value conversion.
+*
+* @par Description
+*    Compares batch conversion of every register value in every output
+*    format with the scalar conversion, over all tail lengths of the
+*    vector kernels.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_batch(void)
+{
+    static uint16_t raw[65536];
+    static int16_t temp_centi[65536];
+    static uint16_t humi_centi[65536];
+    static double temp_double[65536];
+    static double humi_double[65536];
+    static float temp_float[65536];
+    static float humi_float[65536];
+    size_t counts[] = { 0, 1, 7, 15, 17, 65535 };
+    size_t i;
+    size_t k;
+    int bad = 0;
+
+    for (i = 0; i < 65536; i++)
+    {
+        raw[i] = (uint16_t)i;
+    }
+
+    // Every tail length of the vector kernels, from unaligned input
+    for (k = 0; k < sizeof(counts) / sizeof(counts[0]); k++)
+    {
+        hdc1000_convert_batch(raw + 1, raw + 1, counts[k],
+            HDC1000_FMT_CENTI, temp_centi, humi_centi);
+        hdc1000_convert_batch(raw + 1, raw + 1, counts[k],
+            HDC1000_FMT_FLOAT, temp_float, humi_float);
+        for (i = 0; i < counts[k]; i++)
+        {
+            bad += temp_centi[i] != hdc1000_temp_raw_to_centi(raw[i + 1]);
+            bad += humi_centi[i] != hdc1000_humi_raw_to_centi(raw[i + 1]);
+            bad += temp_float[i] !=
+                (float)((((double)raw[i + 1] / 65536.0) * 165.0) - 40.0);
+            bad += humi_float[i] !=
+                (float)(((double)raw[i + 1] / 65536.0) * 100.0);
+        }
+    }
+    CHECK(bad == 0);
+
+    CHECK(hdc1000_convert_batch(raw, raw, 65536, HDC1000_FMT_DOUBLE,
+        temp_double, humi_double) == 0);
+    CHECK(hdc1000_convert_batch(raw, raw, 65536, HDC1000_FMT_FLOAT,
+        temp_float, humi_float) == 0);
+    CHECK(hdc1000_convert_batch(raw, raw, 1, 0xFF, temp_float,
+        humi_float) == -1);
+    for (i = 0, bad = 0; i < 65536; i++)
+    {
+        double temp = (((double)raw[i] / 65536.0) * 165.0) - 40.0;
+        double humi = ((double)raw[i] / 65536.0) * 100.0;
+
+        bad += temp_double[i] != temp || humi_double[i] != humi;
+        bad += temp_float[i] != (float)temp || humi_float[i] != (float)humi;
+    }
+    CHECK(bad == 0);
+
+    // Channel passed as NULL is skipped, the other is converted
+    CHECK(hdc1000_convert_batch(NULL, raw, 16, HDC1000_FMT_CENTI, NULL,
+        humi_centi) == 0);
+    CHECK(humi_centi[15] == hdc1000_humi_raw_to_centi(raw[15]));
+    CHECK(hdc1000_convert_batch(raw, NULL, 16, HDC1000_FMT_DOUBLE,
+        temp_double, NULL) == 0);
+    CHECK(temp_double[15] == (((double)raw[15] / 65536.0) * 165.0) - 40.0);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_batch();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,159 @@
+/***************************************************************************//**
+* @file    hdc1000_error_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 error handling.
+*
+* @par Description
+*    Uses the fault injection of the simulator to check retries with bus
+*    recovery, the time budget of register accesses and DRDYn timeouts
+*    of blocking and split-phase reads.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_retry(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    uint16_t raw = 0xAAAA;
+    uint16_t config;
+
+    // Without retries a NACK fails the read and leaves output unchanged
+    hdc1000_set_retry(p_hdc, 0, 0);
+    sim.fail_next = 1;
+    CHECK(hdc1000_read_temp_raw(p_hdc, &raw) == HDC1000_ERR_IO);
+    CHECK(raw == 0xAAAA);
+
+    // Retries recover the bus and repeat the access
+    hdc1000_set_retry(p_hdc, 2, 100);
+    hdc1000_sim_reset_stats(&sim);
+    sim.fail_next = 2;
+    CHECK(hdc1000_read_temp_raw(p_hdc, &raw) == HDC1000_OK);
+    CHECK(raw != 0xAAAA);
+    CHECK(sim.nacks == 2);
+    CHECK(sim.recoveries == 2);
+
+    // Backoff doubles on every further retry
+    hdc1000_sim_reset_stats(&sim);
+    sim.fail_next = 2;
+    CHECK(hdc1000_read_config(p_hdc, &config) == HDC1000_OK);
+    CHECK(sim.sleep_us == 100 + 200);
+
+    // More failures than retries
+    sim.fail_next = 3;
+    CHECK(hdc1000_read_temp_raw(p_hdc, &raw) == HDC1000_ERR_IO);
+    sim.fail_next = 0;
+
+    // Stuck bus is released by recovery before the first retry
+    hdc1000_sim_reset_stats(&sim);
+    sim.bus_stuck = 1;
+    CHECK(hdc1000_read_humi_raw(p_hdc, &raw) == HDC1000_OK);
+    CHECK(sim.bus_stuck == 0);
+    CHECK(sim.recoveries == 1);
+
+    hdc1000_set_retry(p_hdc, 0, 0);
+    sim.bus_stuck = 1;
+    CHECK(hdc1000_read_humi_raw(p_hdc, &raw) == HDC1000_ERR_IO);
+    sim.bus_stuck = 0;
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_timeout(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    uint32_t budget = 3 * hdc1000_get_conversion_time(p_hdc,
+        HDC1000_REG_TEMP);
+    uint64_t start;
+    uint16_t raw;
+
+    // Retries which would not fit in the budget are not started
+    hdc1000_set_retry(p_hdc, 10, 1000);
+    hdc1000_set_timeout(p_hdc, budget);
+    sim.fail_next = 100;
+    start = sim.now_us;
+    CHECK(hdc1000_read_temp_raw(p_hdc, &raw) == HDC1000_ERR_IO);
+    CHECK(sim.now_us - start <= budget);
+    CHECK(sim.fail_next > 90);
+    sim.fail_next = 0;
+
+    hdc1000_set_timeout(p_hdc, 0);
+    CHECK(hdc1000_read_temp_raw(p_hdc, &raw) == HDC1000_OK);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_drdyn_timeout(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc;
+    uint32_t conv_time;
+    uint32_t remaining;
+    uint64_t start;
+    uint16_t raw;
+    uint8_t edge;
+
+    for (edge = 0; edge < 2; edge++)
+    {
+        p_hdc = open_sim(&sim, DRDYN_PIN);
+        sim.edge_events = edge;
+        sim.drdyn_stuck = 1;
+
+        CHECK(hdc1000_read_temp_raw(p_hdc, &raw) == HDC1000_ERR_TIMEOUT);
+
+        // Split-phase poll gives up past the DRDYn deadline
+        conv_time = (uint32_t)hdc1000_start_measurement(p_hdc,
+            HDC1000_REG_TEMP);
+        CHECK(hdc1000_poll(p_hdc, &remaining) == HDC1000_STATE_BUSY);
+        hdc1000_sim_advance(&sim,
+            (uint64_t)conv_time * HDC1000_DRDYN_TIMEOUT_FACTOR);
+        CHECK(hdc1000_poll(p_hdc, &remaining) == HDC1000_ERR_TIMEOUT);
+
+        // Device is idle again
+        sim.drdyn_stuck = 0;
+        CHECK(hdc1000_start_measurement(p_hdc, HDC1000_REG_TEMP) > 0);
+        hdc1000_sim_advance(&sim, conv_time);
+        CHECK(hdc1000_poll(p_hdc, &remaining) == HDC1000_STATE_READY);
+        CHECK(hdc1000_read_temp_raw(p_hdc, &raw) == HDC1000_OK);
+
+        // Budget shorter than the conversion bounds the whole wait
+        sim.drdyn_stuck = 1;
+        hdc1000_set_retry(p_hdc, 0, 0);
+        hdc1000_set_timeout(p_hdc, conv_time / 2);
+        start = sim.now_us;
+        CHECK(hdc1000_read_temp_raw(p_hdc, &raw) == HDC1000_ERR_TIMEOUT);
+        CHECK(sim.now_us - start <=
+            conv_time / 2 + HDC1000_DRDYN_SLEEP_MAX_US);
+
+        hdc1000_sim_close(p_hdc);
+    }
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_retry();
+    test_timeout();
+    test_drdyn_timeout();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,148 @@
+/***************************************************************************//**
+* @file    hdc1000_filter_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 streaming filter.
+*
+* @par Description
+*    Feeds register values through hdc1000_filter_raw() to check median
+*    and moving average stages, and reads the simulator with oversampling.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Helpers
+*******************************************************************************/
+
+/// <summary>
+///     Simulator callback warming the room by 0.5 degC after every register
+///     access transaction
+/// </summary>
+static int
+ramp_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    hdc1000_sim_t *p_sim = (hdc1000_sim_t *)p_hdc->user_data;
+    int result;
+
+    result = hdc1000_sim_cb(p_hdc, msg, arg_int, arg_ptr);
+    if (msg == HDC1000_MSG_TRANSACTION)
+    {
+        p_sim->ambient_temp += 0.5;
+    }
+    return result;
+}
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_median(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+
+    // Window is limited, median of a partial window is its lower middle
+    hdc1000_set_filter(p_hdc, 1, 9, 0);
+    CHECK(p_hdc->filter_median == HDC1000_FILTER_MEDIAN_MAX);
+    hdc1000_set_filter(p_hdc, 1, 3, 0);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 200) == 200);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 100) == 100);
+
+    // Single spikes are removed, channels are filtered separately
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 9000) == 200);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_HUMI, 5000) == 5000);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 150) == 150);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 0) == 150);
+
+    // Reset forgets the window
+    hdc1000_reset_filter(p_hdc);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 9000) == 9000);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_ema(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+
+    // First value starts the average, later ones move it by 2^-shift
+    hdc1000_set_filter(p_hdc, 1, 1, 2);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 0) == 0);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 1000) == 250);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 1000) == 438);
+
+    // Heated values pass unchanged and are not recorded
+    CHECK(hdc1000_set_heater(p_hdc, HDC1000_CFG_HEAT_ON) == 1);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 60000) == 60000);
+    CHECK(hdc1000_set_heater(p_hdc, HDC1000_CFG_HEAT_OFF) == 1);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 1000) == 578);
+
+    // Saturates at the top of the register range
+    hdc1000_set_filter(p_hdc, 1, 1, 1);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_HUMI, 0xFFFF) == 0xFFFF);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_HUMI, 0xFFFF) == 0xFFFF);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_oversample(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc;
+    uint32_t conv_time;
+    int16_t temp = 0;
+    uint16_t temp_raw = 0;
+    uint16_t humi_raw = 0;
+
+    init_sim(&sim);
+    p_hdc = hdc1000_init_user(sim.i2c_addr, -1, ramp_cb, &sim);
+    CHECK(p_hdc != NULL);
+    hdc1000_set_transaction(p_hdc, 1);
+
+    // Reads average four conversions, taking four conversion times
+    hdc1000_set_filter(p_hdc, 4, 1, 0);
+    conv_time = hdc1000_get_conversion_time(p_hdc, HDC1000_REG_TEMP);
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_OK);
+    CHECK(sim.transactions == 2 * 4);    // Pointer write and read
+    CHECK(sim.sleep_us == 4 * conv_time);
+    CHECK(temp >= 2419 && temp <= 2421);
+
+    // Combined reads average both words
+    sim.ambient_temp = 23.45;
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_read_temp_humi_raw(p_hdc, &temp_raw, &humi_raw) ==
+        HDC1000_OK);
+    CHECK(sim.transactions == 2 * 4);    // Pointer write and read
+    CHECK(hdc1000_temp_raw_to_centi(temp_raw) >= 2419 &&
+        hdc1000_temp_raw_to_centi(temp_raw) <= 2421);
+    CHECK(hdc1000_humi_raw_to_centi(humi_raw) >= 4149 &&
+        hdc1000_humi_raw_to_centi(humi_raw) <= 4151);
+
+    hdc1000_shutdown(p_hdc);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_median();
+    test_ema();
+    test_oversample();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,190 @@
+/***************************************************************************//**
+* @file    hdc1000_group_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 multi-sensor acquisition.
+*
+* @par Description
+*    Reads a group of simulated sensors with hdc1000_read_group(). The
+*    simulators share one time base: after every platform message all of
+*    them are advanced to the latest clock among them, as sensors on one
+*    board would see the same time pass.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+#define GROUP_SIZE          3
+
+/*******************************************************************************
+* Variables
+*******************************************************************************/
+
+static hdc1000_sim_t sims[GROUP_SIZE];
+
+/*******************************************************************************
+* Helpers
+*******************************************************************************/
+
+/// <summary>
+///     Simulator callback keeping clocks of the group in step
+/// </summary>
+static int
+group_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    uint64_t now = 0;
+    int result;
+    size_t i;
+
+    result = hdc1000_sim_cb(p_hdc, msg, arg_int, arg_ptr);
+    for (i = 0; i < GROUP_SIZE; i++)
+    {
+        now = (sims[i].now_us > now) ? sims[i].now_us : now;
+    }
+    for (i = 0; i < GROUP_SIZE; i++)
+    {
+        hdc1000_sim_advance(&sims[i], now - sims[i].now_us);
+    }
+    return result;
+}
+
+/// <summary>
+///     Initialize group of simulators at different temperatures and open
+///     drivers on them
+/// </summary>
+static void
+open_group(hdc1000_t **pp_hdc, int drdyn_pin)
+{
+    size_t i;
+
+    for (i = 0; i < GROUP_SIZE; i++)
+    {
+        init_sim(&sims[i]);
+        sims[i].ambient_temp = 20.0 + 5.0 * (double)i;
+        pp_hdc[i] = hdc1000_init_user(sims[i].i2c_addr, drdyn_pin, group_cb,
+            &sims[i]);
+        CHECK(pp_hdc[i] != NULL);
+        hdc1000_set_retry(pp_hdc[i], 0, 0);
+    }
+}
+
+static void
+close_group(hdc1000_t **pp_hdc)
+{
+    size_t i;
+
+    for (i = 0; i < GROUP_SIZE; i++)
+    {
+        hdc1000_shutdown(pp_hdc[i]);
+    }
+}
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_group(void)
+{
+    hdc1000_t *p_hdc[GROUP_SIZE];
+    uint16_t temp[GROUP_SIZE];
+    uint16_t humi[GROUP_SIZE];
+    int status[GROUP_SIZE];
+    uint32_t conv_time;
+    uint64_t start;
+    int16_t centi;
+    size_t i;
+
+    open_group(p_hdc, -1);
+
+    // Sensors may differ in resolution, the longest conversion bounds
+    // the whole group
+    CHECK(hdc1000_set_resolution(p_hdc[1], HDC1000_CFG_TEMP_11BIT |
+        HDC1000_CFG_HUMI_8BIT) == 1);
+    conv_time = hdc1000_get_conversion_time(p_hdc[0], HDC1000_REG_TEMP);
+    start = sims[0].now_us;
+    CHECK(hdc1000_read_group(p_hdc, GROUP_SIZE, HDC1000_REG_TEMP, temp,
+        humi, status) == GROUP_SIZE);
+    CHECK(sims[0].now_us - start < 2 * (uint64_t)conv_time);
+    for (i = 0; i < GROUP_SIZE; i++)
+    {
+        centi = hdc1000_temp_raw_to_centi(temp[i]);
+        CHECK(status[i] == HDC1000_OK);
+        CHECK(centi >= 1990 + 500 * (int)i && centi <= 2010 + 500 * (int)i);
+        CHECK(hdc1000_humi_raw_to_centi(humi[i]) >= 4100 &&
+            hdc1000_humi_raw_to_centi(humi[i]) <= 4200);
+        CHECK(hdc1000_poll(p_hdc[i], NULL) == HDC1000_STATE_IDLE);
+    }
+
+    // Failed sensor does not stop the others
+    sims[1].fail_next = 1;
+    CHECK(hdc1000_read_group(p_hdc, GROUP_SIZE, HDC1000_REG_TEMP, temp,
+        NULL, status) == GROUP_SIZE - 1);
+    CHECK(status[0] == HDC1000_OK);
+    CHECK(status[1] == HDC1000_ERR_IO);
+    CHECK(status[2] == HDC1000_OK);
+
+    // Pending split-phase measurement is not taken over by the group
+    CHECK(hdc1000_start_measurement(p_hdc[2], HDC1000_REG_TEMP) > 0);
+    CHECK(hdc1000_read_group(p_hdc, GROUP_SIZE, HDC1000_REG_TEMP, temp,
+        NULL, status) == 0);
+    for (i = 0; i < GROUP_SIZE; i++)
+    {
+        CHECK(status[i] == HDC1000_ERR_NOT_READY);
+    }
+    CHECK(hdc1000_poll(p_hdc[2], NULL) == HDC1000_STATE_BUSY);
+
+    close_group(p_hdc);
+}
+
+static void
+test_group_timeout(void)
+{
+    hdc1000_t *p_hdc[GROUP_SIZE];
+    uint16_t temp[GROUP_SIZE];
+    int status[GROUP_SIZE];
+    uint32_t conv_time;
+    uint64_t start;
+    size_t i;
+
+    // Sensor whose DRDYn stays HIGH is abandoned at the group deadline
+    open_group(p_hdc, DRDYN_PIN);
+    sims[2].drdyn_stuck = 1;
+    conv_time = hdc1000_get_conversion_time(p_hdc[0], HDC1000_REG_TEMP);
+    start = sims[0].now_us;
+    CHECK(hdc1000_read_group(p_hdc, GROUP_SIZE, HDC1000_REG_TEMP, temp,
+        NULL, status) == GROUP_SIZE - 1);
+    CHECK(status[0] == HDC1000_OK);
+    CHECK(status[1] == HDC1000_OK);
+    CHECK(status[2] == HDC1000_ERR_TIMEOUT);
+    CHECK(sims[0].now_us - start <= (uint64_t)conv_time *
+        HDC1000_DRDYN_TIMEOUT_FACTOR + HDC1000_DRDYN_SLEEP_MAX_US);
+    for (i = 0; i < GROUP_SIZE; i++)
+    {
+        CHECK(hdc1000_poll(p_hdc[i], NULL) == HDC1000_STATE_IDLE);
+    }
+
+    close_group(p_hdc);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_group();
+    test_group_timeout();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,207 @@
+/***************************************************************************//**
+* @file    hdc1000_hpp_test.cpp
+* @version 1.0.0
+*
+* @brief Tests of C++ wrapper hdc1000.hpp against simulated device.
+*
+* @par Description
+*    Builds hdc1000::Sensor with SimBackend for several resolutions and
+*    modes, checks configuration written to the device, readings, error
+*    propagation and ownership transfer. Prints failed checks and returns
+*    non-zero if any failed.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include <cstdio>
+#include <utility>
+
+#include "hdc1000_sim.h"
+#include "hdc1000.hpp"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+#define CHECK(cond) check((cond), #cond, __FILE__, __LINE__)
+
+#define DRDYN_PIN           1
+
+/*******************************************************************************
+* Helpers
+*******************************************************************************/
+
+namespace {
+
+int checks;
+int failures;
+
+void
+check(bool cond, const char *text, const char *file, int line)
+{
+    checks++;
+    if (!cond) {
+        failures++;
+        std::printf("%s:%d: check failed: %s\n", file, line, text);
+    }
+}
+
+void
+init_sim(hdc1000_sim_t &sim)
+{
+    hdc1000_sim_init(&sim);
+    sim.ambient_temp = 23.45;
+    sim.ambient_humi = 41.5;
+}
+
+bool
+near(double value, double expected, double tolerance)
+{
+    return value >= expected - tolerance && value <= expected + tolerance;
+}
+
+using Fast = hdc1000::Resolution<hdc1000::TempRes::Bits11,
+    hdc1000::HumiRes::Bits8>;
+
+static_assert(Fast::temp_time_us == HDC1000_CONV_TIME_TEMP_11BIT,
+    "Temperature conversion time");
+static_assert(Fast::humi_time_us == HDC1000_CONV_TIME_HUMI_8BIT,
+    "Humidity conversion time");
+static_assert(hdc1000::Sensor<hdc1000::SimBackend, Fast,
+    hdc1000::Mode::Single>::humi_time_us ==
+    HDC1000_CONV_TIME_MARGIN_US + HDC1000_CONV_TIME_HUMI_8BIT,
+    "Single mode read time");
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+void
+test_combined()
+{
+    hdc1000_sim_t sim;
+    init_sim(sim);
+
+    hdc1000::Sensor<hdc1000::SimBackend> sensor(&sim);
+    hdc1000::Celsius temp;
+    hdc1000::RelHumidity humi;
+
+    CHECK(sensor.valid());
+    CHECK(sensor.error() == HDC1000_OK);
+    CHECK((sim.config_reg & HDC1000_SIM_CFG_MODE) != 0);
+    CHECK((sim.config_reg & (HDC1000_SIM_CFG_TRES | HDC1000_SIM_CFG_HRES))
+        == 0);
+
+    CHECK(sensor.read(temp, humi) == HDC1000_OK);
+    CHECK(near(temp.value, 23.45, 0.01));
+    CHECK(near(humi.value, 41.5, 0.01));
+
+    CHECK(sensor.set_heater(true) == 1);
+    CHECK((sim.config_reg & HDC1000_SIM_CFG_HEAT) != 0);
+    CHECK(sensor.set_heater(false) == 1);
+}
+
+void
+test_single_low_resolution()
+{
+    hdc1000_sim_t sim;
+    init_sim(sim);
+
+    hdc1000::Sensor<hdc1000::SimBackend, Fast, hdc1000::Mode::Single>
+        sensor(&sim, DRDYN_PIN);
+    hdc1000::Celsius temp;
+    hdc1000::RelHumidity humi;
+
+    CHECK(sensor.valid());
+    CHECK((sim.config_reg & HDC1000_SIM_CFG_MODE) == 0);
+    CHECK((sim.config_reg & HDC1000_SIM_CFG_TRES) != 0);
+    CHECK((sim.config_reg & HDC1000_SIM_CFG_HRES) == 0x0200);
+
+    CHECK(sensor.read(temp) == HDC1000_OK);
+    CHECK(sensor.read(humi) == HDC1000_OK);
+    CHECK(near(temp.value, 23.45, 0.1));
+    CHECK(near(humi.value, 41.5, 0.4));
+}
+
+void
+test_errors()
+{
+    hdc1000_sim_t sim;
+    init_sim(sim);
+
+    hdc1000::Sensor<hdc1000::SimBackend> sensor(&sim, DRDYN_PIN);
+    hdc1000::Celsius temp(-1.0);
+    hdc1000::RelHumidity humi(-1.0);
+
+    // Outputs are left unchanged on failure
+    sim.drdyn_stuck = 1;
+    CHECK(sensor.read(temp, humi) == HDC1000_ERR_TIMEOUT);
+    CHECK(temp.value == -1.0 && humi.value == -1.0);
+    sim.drdyn_stuck = 0;
+
+    hdc1000_set_retry(sensor.get(), 0, 0);
+    sim.bus_stuck = 1;
+    CHECK(sensor.read(temp) == HDC1000_ERR_IO);
+    CHECK(temp.value == -1.0);
+    sim.bus_stuck = 0;
+
+    CHECK(sensor.read(temp) == HDC1000_OK);
+}
+
+void
+test_config_failure()
+{
+    hdc1000_sim_t sim;
+    init_sim(sim);
+
+    // Configuration register cannot be written, handle is released
+    sim.fail_next = 1000;
+    hdc1000::Sensor<hdc1000::SimBackend> sensor(&sim);
+
+    CHECK(!sensor.valid());
+    CHECK(sensor.error() == HDC1000_ERR_IO);
+    CHECK(sensor.get() == nullptr);
+}
+
+void
+test_move()
+{
+    hdc1000_sim_t sim;
+    init_sim(sim);
+
+    hdc1000::Sensor<hdc1000::SimBackend> first(&sim);
+    hdc1000_t *p_hdc = first.get();
+    hdc1000::Sensor<hdc1000::SimBackend> second(std::move(first));
+    hdc1000::Celsius temp;
+
+    CHECK(!first.valid());
+    CHECK(second.get() == p_hdc);
+    CHECK(second.read(temp) == HDC1000_OK);
+
+    first = std::move(second);
+    CHECK(first.get() == p_hdc);
+    CHECK(!second.valid());
+}
+
+} // namespace
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main()
+{
+    test_combined();
+    test_single_low_resolution();
+    test_errors();
+    test_config_failure();
+    test_move();
+
+    std::printf("%d checks, %d failed\n", checks, failures);
+    return (failures == 0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,283 @@
+/***************************************************************************//**
+* @file    hdc1000_linux_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 Linux platform wrapper.
+*
+* @par Description
+*    Opens lib_hdc1000_linux.c on /dev/null and links with ioctl wrapped
+*    (-Wl,--wrap=ioctl), so its I2C_RDWR transfers reach the simulator
+*    instead of i2c-dev. The simulator clock follows CLOCK_MONOTONIC, the
+*    time base of the wrapper and its timerfd. Checks how register
+*    accesses map to I2C_RDWR calls, and the event loop integration driven
+*    by poll() on the descriptor of hdc1000_async_get_fd().
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include <errno.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#include "hdc1000_test.h"
+#include "lib_hdc1000_linux.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+// Longest wait for the descriptor to become readable
+#define EVENT_TIMEOUT_MS    1000
+
+/*******************************************************************************
+* Types
+*******************************************************************************/
+
+typedef struct
+{
+    int calls;
+    int status;
+    uint16_t temp_raw;
+    uint16_t humi_raw;
+} ready_t;
+
+/*******************************************************************************
+* Variables
+*******************************************************************************/
+
+static hdc1000_sim_t sim;
+
+// I2C_RDWR calls and messages of the last call
+static uint32_t rdwr_calls;
+static uint32_t rdwr_nmsgs;
+
+/*******************************************************************************
+* Helpers
+*******************************************************************************/
+
+int
+__real_ioctl(int fd, unsigned long request, ...);
+
+/// <summary>
+///     Advance simulator clock to monotonic time
+/// </summary>
+static void
+sync_clock(void)
+{
+    struct timespec ts;
+    uint64_t now;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+    if (now > sim.now_us)
+    {
+        hdc1000_sim_advance(&sim, now - sim.now_us);
+    }
+}
+
+/// <summary>
+///     Serve I2C_RDWR from the simulator, pass other requests to ioctl()
+/// </summary>
+int
+__wrap_ioctl(int fd, unsigned long request, ...)
+{
+    struct i2c_rdwr_ioctl_data *p_rdwr;
+    hdc1000_t bus;
+    va_list args;
+    uint32_t i;
+    int result = 0;
+
+    va_start(args, request);
+    p_rdwr = va_arg(args, struct i2c_rdwr_ioctl_data *);
+    va_end(args);
+
+    if (request != I2C_RDWR)
+    {
+        return __real_ioctl(fd, request, p_rdwr);
+    }
+
+    sync_clock();
+    rdwr_calls++;
+    rdwr_nmsgs = p_rdwr->nmsgs;
+    bus.user_data = &sim;
+    for (i = 0; i < p_rdwr->nmsgs && result >= 0; i++)
+    {
+        bus.i2c_addr = (uint8_t)p_rdwr->msgs[i].addr;
+        result = hdc1000_sim_cb(&bus, (p_rdwr->msgs[i].flags & I2C_M_RD) ?
+            HDC1000_MSG_I2C_READ_BYTES : HDC1000_MSG_I2C_WRITE_BYTES,
+            (uint8_t)p_rdwr->msgs[i].len, p_rdwr->msgs[i].buf);
+    }
+    if (result < 0)
+    {
+        errno = EIO;
+        return -1;
+    }
+    return 0;
+}
+
+static void
+ready_cb(hdc1000_t *p_hdc, int status, uint16_t temp_raw,
+    uint16_t humi_raw, void *context)
+{
+    ready_t *p_ready = (ready_t *)context;
+
+    p_ready->calls++;
+    p_ready->status = status;
+    p_ready->temp_raw = temp_raw;
+    p_ready->humi_raw = humi_raw;
+}
+
+/// <summary>
+///     Handle descriptor events until the measurement completes
+/// </summary>
+/// <returns>Last result of hdc1000_async_handle_event(), -1 if the
+/// descriptor did not become readable in time</returns>
+static int
+run_events(hdc1000_t *p_hdc)
+{
+    struct pollfd pfd;
+    int result = 0;
+
+    pfd.fd = hdc1000_async_get_fd(p_hdc);
+    pfd.events = POLLIN;
+    while (result == 0)
+    {
+        if (poll(&pfd, 1, EVENT_TIMEOUT_MS) != 1)
+        {
+            return -1;
+        }
+        result = hdc1000_async_handle_event(p_hdc);
+    }
+    return result;
+}
+
+/// <summary>
+///     Initialize simulator and open Linux wrapper on it
+/// </summary>
+static hdc1000_t
+*open_linux(void)
+{
+    hdc1000_t *p_hdc;
+
+    init_sim(&sim);
+    sim.bus_hz = 0;
+    sync_clock();
+
+    p_hdc = hdc1000_linux_open("/dev/null", sim.i2c_addr, NULL, -1);
+    CHECK(p_hdc != NULL);
+    return p_hdc;
+}
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_transfers(void)
+{
+    hdc1000_t *p_hdc = open_linux();
+    uint16_t config;
+    int16_t temp = 0;
+    uint8_t transaction;
+
+    if (p_hdc == NULL)
+    {
+        return;
+    }
+
+    // Pointer write and register read share one call with repeated
+    // start, in a transaction and as deferred single byte write
+    for (transaction = 0; transaction < 2; transaction++)
+    {
+        hdc1000_set_transaction(p_hdc, transaction);
+        rdwr_calls = 0;
+        CHECK(hdc1000_read_config(p_hdc, &config) == HDC1000_OK);
+        CHECK(rdwr_calls == 1 && rdwr_nmsgs == 2);
+    }
+
+    // Configuration register is written in one message
+    rdwr_calls = 0;
+    CHECK(hdc1000_set_mode(p_hdc, HDC1000_CFG_SINGLE_MEASUR) == 1);
+    CHECK(rdwr_calls == 1 && rdwr_nmsgs == 1);
+    CHECK((sim.config_reg >> 8) == (HDC1000_CFG_DEFAULT &
+        (uint8_t)~HDC1000_CFG_BOTH_TEMP_HUMI));
+
+    // Trigger is separated from the result read by the conversion
+    rdwr_calls = 0;
+    CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_OK);
+    CHECK(rdwr_calls == 2 && rdwr_nmsgs == 1);
+    CHECK(temp >= 2344 && temp <= 2346);
+
+    hdc1000_linux_close(p_hdc);
+}
+
+static void
+test_async(void)
+{
+    struct pollfd pfd;
+    hdc1000_t *p_hdc = open_linux();
+    ready_t ready = { 0 };
+
+    if (p_hdc == NULL)
+    {
+        return;
+    }
+
+    // Timer descriptor is not readable until a measurement is started
+    pfd.fd = hdc1000_async_get_fd(p_hdc);
+    pfd.events = POLLIN;
+    CHECK(pfd.fd != -1);
+    CHECK(poll(&pfd, 1, 0) == 0);
+
+    // Combined mode measurement completes through the descriptor
+    CHECK(hdc1000_async_start(p_hdc, HDC1000_REG_TEMP, ready_cb,
+        &ready) == 0);
+    CHECK(run_events(p_hdc) == 1);
+    CHECK(ready.calls == 1);
+    CHECK(ready.status == HDC1000_OK);
+    CHECK(hdc1000_temp_raw_to_centi(ready.temp_raw) >= 2344 &&
+        hdc1000_temp_raw_to_centi(ready.temp_raw) <= 2346);
+    CHECK(hdc1000_humi_raw_to_centi(ready.humi_raw) >= 4149 &&
+        hdc1000_humi_raw_to_centi(ready.humi_raw) <= 4151);
+    CHECK(hdc1000_poll(p_hdc, NULL) == HDC1000_STATE_IDLE);
+
+    // Trigger NACKed in the deferred write is reported by start, the
+    // completion callback is not invoked
+    hdc1000_set_retry(p_hdc, 0, 0);
+    sim.fail_next = 1;
+    CHECK(hdc1000_async_start(p_hdc, HDC1000_REG_HUMI, ready_cb,
+        &ready) == -1);
+    CHECK(ready.calls == 1);
+    CHECK(hdc1000_poll(p_hdc, NULL) == HDC1000_STATE_IDLE);
+
+    // Result read failing after the conversion reaches the callback
+    CHECK(hdc1000_async_start(p_hdc, HDC1000_REG_HUMI, ready_cb,
+        &ready) == 0);
+    sim.fail_next = 1;
+    CHECK(run_events(p_hdc) == 1);
+    CHECK(ready.calls == 2);
+    CHECK(ready.status == HDC1000_ERR_IO);
+
+    hdc1000_linux_close(p_hdc);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_transfers();
+    test_async();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
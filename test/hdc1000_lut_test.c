@@ -0,0 +1,109 @@
+/***************************************************************************//**
+* @file    hdc1000_lut_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 lookup table conversion.
+*
+* @par Description
+*    Compares the 11-bit and 8-bit lookup tables with arithmetic
+*    conversion, directly and through the centi getters reading the
+*    simulator at low resolution.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_lut(void)
+{
+    static uint16_t raw[65536];
+    static int16_t temp_centi[65536];
+    static uint16_t humi_centi[65536];
+    static int16_t temp_lut[65536];
+    static uint16_t humi_lut[65536];
+    size_t i;
+    int bad = 0;
+
+    // Tables equal arithmetic conversion for values the device returns
+    for (i = 0; i < 65536; i++)
+    {
+        raw[i] = (uint16_t)(i & 0xFFE0);
+    }
+    hdc1000_convert_lut(raw, raw, 65536,
+        HDC1000_CFG_TEMP_11BIT | HDC1000_CFG_HUMI_11BIT, temp_lut, humi_lut);
+    hdc1000_convert_batch(raw, raw, 65536, HDC1000_FMT_CENTI, temp_centi,
+        humi_centi);
+    for (i = 0, bad = 0; i < 65536; i++)
+    {
+        bad += temp_lut[i] != temp_centi[i] || humi_lut[i] != humi_centi[i];
+    }
+    CHECK(bad == 0);
+
+    for (i = 0; i < 65536; i++)
+    {
+        raw[i] = (uint16_t)(i & 0xFF00);
+    }
+    hdc1000_convert_lut(NULL, raw, 65536, HDC1000_CFG_HUMI_8BIT, NULL,
+        humi_lut);
+    hdc1000_convert_batch(NULL, raw, 65536, HDC1000_FMT_CENTI, NULL,
+        humi_centi);
+    for (i = 0, bad = 0; i < 65536; i++)
+    {
+        bad += humi_lut[i] != humi_centi[i];
+    }
+    CHECK(bad == 0);
+}
+
+static void
+test_low_resolution(void)
+{
+    uint8_t resolutions[] = {
+        HDC1000_CFG_TEMP_11BIT | HDC1000_CFG_HUMI_11BIT,
+        HDC1000_CFG_HUMI_8BIT
+    };
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc;
+    uint16_t temp_raw;
+    uint16_t humi_raw;
+    int16_t temp;
+    uint16_t humi;
+    size_t i;
+
+    for (i = 0; i < sizeof(resolutions); i++)
+    {
+        p_hdc = open_sim(&sim, -1);
+        CHECK(hdc1000_set_resolution(p_hdc, resolutions[i]) == 1);
+
+        // Table lookup of centi getters matches arithmetic conversion
+        CHECK(hdc1000_read_temp_raw(p_hdc, &temp_raw) == HDC1000_OK);
+        CHECK(hdc1000_read_humi_raw(p_hdc, &humi_raw) == HDC1000_OK);
+        CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_OK);
+        CHECK(hdc1000_read_humi_centi(p_hdc, &humi) == HDC1000_OK);
+        CHECK(temp == hdc1000_temp_raw_to_centi(temp_raw));
+        CHECK(humi == hdc1000_humi_raw_to_centi(humi_raw));
+
+        hdc1000_sim_close(p_hdc);
+    }
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_lut();
+    test_low_resolution();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,99 @@
+/***************************************************************************//**
+* @file    hdc1000_pool_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 device storage.
+*
+* @par Description
+*    Built with the driver sources and HDC1000_POOL_SIZE of 2, so devices
+*    are taken from the static pool. Storage given to hdc1000_init_static()
+*    is used as is in any build.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_pool(void)
+{
+    hdc1000_sim_t sim[3];
+    hdc1000_t *p_hdc[3];
+    hdc1000_t *p_first;
+    int16_t temp;
+
+    CHECK(HDC1000_POOL_SIZE == 2);
+
+    // Pool runs out after its devices are taken
+    p_hdc[0] = open_sim(&sim[0], -1);
+    p_hdc[1] = open_sim(&sim[1], -1);
+    CHECK(p_hdc[0] != p_hdc[1]);
+    CHECK(p_hdc[0]->storage == HDC1000_STORAGE_POOL);
+    CHECK(p_hdc[1]->storage == HDC1000_STORAGE_POOL);
+    init_sim(&sim[2]);
+    CHECK(hdc1000_sim_open(&sim[2], -1) == NULL);
+
+    // Shutdown returns the device to the pool
+    p_first = p_hdc[0];
+    hdc1000_sim_close(p_hdc[0]);
+    p_hdc[2] = hdc1000_sim_open(&sim[2], -1);
+    CHECK(p_hdc[2] == p_first);
+    CHECK(p_hdc[2]->storage == HDC1000_STORAGE_POOL);
+    CHECK(p_hdc[2]->user_data == &sim[2]);
+    CHECK(hdc1000_read_temp_centi(p_hdc[2], &temp) == HDC1000_OK);
+    CHECK(temp >= 2340 && temp <= 2350);
+
+    hdc1000_sim_close(p_hdc[1]);
+    hdc1000_sim_close(p_hdc[2]);
+}
+
+static void
+test_init_static(void)
+{
+    hdc1000_sim_t sim[3];
+    hdc1000_t *p_hdc[2];
+    hdc1000_t dev;
+    int16_t temp;
+
+    CHECK(hdc1000_init_static(NULL, 0, -1, hdc1000_sim_cb, NULL) == NULL);
+
+    // Caller storage does not take a pool device
+    p_hdc[0] = open_sim(&sim[0], -1);
+    init_sim(&sim[2]);
+    CHECK(hdc1000_init_static(&dev, sim[2].i2c_addr, -1, hdc1000_sim_cb,
+        &sim[2]) == &dev);
+    CHECK(dev.storage == HDC1000_STORAGE_CALLER);
+    p_hdc[1] = open_sim(&sim[1], -1);
+    CHECK(p_hdc[1] != NULL && p_hdc[1] != &dev);
+    CHECK(hdc1000_read_temp_centi(&dev, &temp) == HDC1000_OK);
+    CHECK(temp >= 2340 && temp <= 2350);
+
+    // Shutdown leaves caller storage to the caller, pool stays full
+    hdc1000_shutdown(&dev);
+    CHECK(dev.storage == HDC1000_STORAGE_CALLER);
+    CHECK(hdc1000_sim_open(&sim[2], -1) == NULL);
+
+    hdc1000_sim_close(p_hdc[0]);
+    hdc1000_sim_close(p_hdc[1]);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_pool();
+    test_init_static();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,215 @@
+/***************************************************************************//**
+* @file    hdc1000_psychro_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 derived humidity metrics.
+*
+* @par Description
+*    Compares dew point and absolute humidity with the Magnus formula and
+*    heat index with the NWS formula in double precision, over the whole
+*    temperature range and 1 %RH to 100 %RH, within the errors documented
+*    in hdc1000_psychro.c.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include <math.h>
+
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+#define GRID_TEMP_STEP      64
+#define GRID_HUMI_COUNT     100
+
+/*******************************************************************************
+* Helpers
+*******************************************************************************/
+
+/// <summary>
+///     Temperature in degC of register value
+/// </summary>
+static double
+temp_of(uint16_t temp_raw)
+{
+    return (double)temp_raw * 165.0 / 65536.0 - 40.0;
+}
+
+/// <summary>
+///     Relative humidity in %RH of register value
+/// </summary>
+static double
+humi_of(uint16_t humi_raw)
+{
+    return (double)humi_raw * 100.0 / 65536.0;
+}
+
+/// <summary>
+///     Register value of relative humidity i %RH, 1 to 100
+/// </summary>
+static uint16_t
+humi_raw_of(int i)
+{
+    uint32_t raw = (uint32_t)i * 65536 / 100;
+
+    return (uint16_t)((raw > 0xFFFF) ? 0xFFFF : raw);
+}
+
+/// <summary>
+///     Dew point in degC, Magnus formula over water
+/// </summary>
+static double
+ref_dew_point(double t, double rh)
+{
+    double gamma = log(rh / 100.0) + 17.62 * t / (243.12 + t);
+
+    return 243.12 * gamma / (17.62 - gamma);
+}
+
+/// <summary>
+///     Absolute humidity in g/m3, Magnus saturation vapour pressure
+/// </summary>
+static double
+ref_abs_humi(double t, double rh)
+{
+    double e = rh / 100.0 * 611.2 * exp(17.62 * t / (243.12 + t));
+
+    return 2.167 * e / (t + 273.15);
+}
+
+/// <summary>
+///     NWS heat index in degC
+/// </summary>
+static double
+ref_heat_index(double t, double rh)
+{
+    double f = t * 1.8 + 32.0;
+    double hi = 0.5 * (0.5 * (f + 61.0 + (f - 68.0) * 1.2 + rh * 0.094) + f);
+
+    if (hi >= 80.0)
+    {
+        hi = -42.379 + 2.04901523 * f + 10.14333127 * rh
+            - 0.22475541 * f * rh - 0.00683783 * f * f
+            - 0.05481717 * rh * rh + 0.00122874 * f * f * rh
+            + 0.00085282 * f * rh * rh - 0.00000199 * f * f * rh * rh;
+        if (rh < 13.0 && f > 80.0 && f < 112.0)
+        {
+            hi -= ((13.0 - rh) / 4.0) * sqrt((17.0 - fabs(f - 95.0)) / 17.0);
+        }
+        else if (rh > 85.0 && f > 80.0 && f < 87.0)
+        {
+            hi += ((rh - 85.0) / 10.0) * ((87.0 - f) / 5.0);
+        }
+    }
+    return (hi - 32.0) / 1.8;
+}
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_reference(void)
+{
+    double dew_err = 0.0;
+    double hi_err = 0.0;
+    double t;
+    double rh;
+    double ref;
+    double err;
+    uint32_t temp_raw;
+    uint16_t humi_raw;
+    int bad_abs = 0;
+    int i;
+
+    for (temp_raw = 0; temp_raw <= 0xFFFF; temp_raw += GRID_TEMP_STEP)
+    {
+        for (i = 1; i <= GRID_HUMI_COUNT; i++)
+        {
+            humi_raw = humi_raw_of(i);
+            t = temp_of((uint16_t)temp_raw);
+            rh = humi_of(humi_raw);
+
+            err = fabs(hdc1000_dew_point_centi((uint16_t)temp_raw,
+                humi_raw) / 100.0 - ref_dew_point(t, rh));
+            dew_err = (err > dew_err) ? err : dew_err;
+
+            ref = ref_abs_humi(t, rh);
+            err = fabs(hdc1000_abs_humi_centi((uint16_t)temp_raw,
+                humi_raw) / 100.0 - ref);
+            bad_abs += err > 0.01 && err > 0.0015 * ref;
+
+            ref = ref_heat_index(t, rh);
+            err = fabs(hdc1000_heat_index_centi((uint16_t)temp_raw,
+                humi_raw) / 100.0 - ref);
+            hi_err = (ref < 327.67 && err > hi_err) ? err : hi_err;
+        }
+    }
+
+    // Heat index is single precision, it stays within the output rounding
+    CHECK(dew_err <= 0.01);
+    CHECK(bad_abs == 0);
+    CHECK(hi_err <= 0.01);
+
+    // Saturated heat index is clipped
+    CHECK(hdc1000_heat_index_centi(0xFFFF, 0xFFFF) == INT16_MAX);
+}
+
+static void
+test_batch(void)
+{
+    uint16_t temp_raw[GRID_HUMI_COUNT];
+    uint16_t humi_raw[GRID_HUMI_COUNT];
+    int16_t dew_point[GRID_HUMI_COUNT];
+    uint32_t abs_humi[GRID_HUMI_COUNT];
+    int16_t heat_index[GRID_HUMI_COUNT];
+    int bad = 0;
+    int i;
+
+    for (i = 0; i < GRID_HUMI_COUNT; i++)
+    {
+        temp_raw[i] = (uint16_t)(i * 655);
+        humi_raw[i] = humi_raw_of(i + 1);
+        heat_index[i] = 0x5A5A;
+    }
+
+    // Batch gives scalar results, outputs passed as NULL are skipped
+    hdc1000_psychro_batch(temp_raw, humi_raw, GRID_HUMI_COUNT, dew_point,
+        abs_humi, NULL);
+    for (i = 0; i < GRID_HUMI_COUNT; i++)
+    {
+        bad += dew_point[i] !=
+            hdc1000_dew_point_centi(temp_raw[i], humi_raw[i]);
+        bad += abs_humi[i] != hdc1000_abs_humi_centi(temp_raw[i], humi_raw[i]);
+        bad += heat_index[i] != 0x5A5A;
+    }
+    CHECK(bad == 0);
+
+    hdc1000_psychro_batch(temp_raw, humi_raw, GRID_HUMI_COUNT, NULL, NULL,
+        heat_index);
+    for (i = 0, bad = 0; i < GRID_HUMI_COUNT; i++)
+    {
+        bad += heat_index[i] !=
+            hdc1000_heat_index_centi(temp_raw[i], humi_raw[i]);
+    }
+    CHECK(bad == 0);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_reference();
+    test_batch();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
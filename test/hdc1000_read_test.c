@@ -0,0 +1,90 @@
+/***************************************************************************//**
+* @file    hdc1000_read_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 blocking reads.
+*
+* @par Description
+*    Reads temperature and humidity from the simulator one at a time and
+*    from one combined acquisition.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_read(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    int16_t temp = 0;
+    uint16_t humi = 0;
+
+    CHECK(hdc1000_get_mf_id(p_hdc) == HDC1000_SIM_MFID);
+    CHECK(hdc1000_get_dev_id(p_hdc) == HDC1000_SIM_DEVID);
+
+    CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_OK);
+    CHECK(hdc1000_read_humi_centi(p_hdc, &humi) == HDC1000_OK);
+    CHECK(temp >= 2344 && temp <= 2346);
+    CHECK(humi >= 4149 && humi <= 4151);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_combined(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    uint32_t conv_time;
+    uint64_t start;
+    uint16_t temp = 0;
+    uint16_t humi = 0;
+    double temp_c = 0.0;
+    double humi_rh = 0.0;
+
+    // Combined read needs combined acquisition mode
+    CHECK(hdc1000_set_mode(p_hdc, HDC1000_CFG_SINGLE_MEASUR) == 1);
+    CHECK(hdc1000_read_temp_humi_raw(p_hdc, &temp, &humi) ==
+        HDC1000_ERR_MODE);
+    CHECK(hdc1000_set_mode(p_hdc, HDC1000_CFG_BOTH_TEMP_HUMI) == 1);
+
+    // Both values come from one conversion
+    conv_time = hdc1000_get_conversion_time(p_hdc, HDC1000_REG_TEMP);
+    start = sim.now_us;
+    CHECK(hdc1000_read_temp_humi_raw(p_hdc, &temp, &humi) == HDC1000_OK);
+    CHECK(sim.now_us - start >= conv_time);
+    CHECK(sim.now_us - start < 2 * (uint64_t)conv_time);
+    CHECK(hdc1000_temp_raw_to_centi(temp) >= 2344 &&
+        hdc1000_temp_raw_to_centi(temp) <= 2346);
+    CHECK(hdc1000_humi_raw_to_centi(humi) >= 4149 &&
+        hdc1000_humi_raw_to_centi(humi) <= 4151);
+
+    CHECK(hdc1000_read_temp_humi(p_hdc, &temp_c, &humi_rh) == HDC1000_OK);
+    CHECK(temp_c > 23.4 && temp_c < 23.5);
+    CHECK(humi_rh > 41.4 && humi_rh < 41.6);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_read();
+    test_combined();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,224 @@
+/***************************************************************************//**
+* @file    hdc1000_sampler_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 background sampler.
+*
+* @par Description
+*    Runs the sampler thread on the simulator. Conversions take no real
+*    time there, so sampling follows the period and the tests stay short.
+*    Heater schedule tests check burst and blackout handling of samples
+*    and device filters.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include <time.h>
+
+#include "hdc1000_sampler.h"
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Helpers
+*******************************************************************************/
+
+static void
+sleep_ms(long msec)
+{
+    struct timespec ts;
+
+    ts.tv_sec = msec / 1000;
+    ts.tv_nsec = (msec % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_sampler_stop(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    hdc1000_sampler_t *p_sampler;
+    double start;
+
+    CHECK(hdc1000_sampler_create(p_hdc, 1000, 3) == NULL);
+    p_sampler = hdc1000_sampler_create(p_hdc, 0, 4);
+    CHECK(p_sampler != NULL);
+    CHECK(hdc1000_sampler_start(p_sampler) == -1);
+    hdc1000_sampler_destroy(p_sampler);
+
+    // Stop wakes the thread sleeping through a long period
+    p_sampler = hdc1000_sampler_create(p_hdc, 10000000, 4);
+    CHECK(p_sampler != NULL);
+    CHECK(hdc1000_sampler_start(p_sampler) == 0);
+    CHECK(hdc1000_sampler_start(p_sampler) == -1);
+    start = wall_time();
+    hdc1000_sampler_stop(p_sampler);
+    CHECK(wall_time() - start < 1.0);
+    hdc1000_sampler_destroy(p_sampler);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_sampling(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    hdc1000_sampler_t *p_sampler;
+    hdc1000_sample_t samples[64];
+    size_t count;
+    size_t i;
+    int bad = 0;
+
+    // Samples are taken in order, at most one per period. A late thread
+    // catches up with the schedule, so spacing may be shorter.
+    p_sampler = hdc1000_sampler_create(p_hdc, 5000, 64);
+    CHECK(p_sampler != NULL);
+    CHECK(hdc1000_sampler_start(p_sampler) == 0);
+    sleep_ms(60);
+    hdc1000_sampler_stop(p_sampler);
+
+    count = hdc1000_sampler_drain(p_sampler, samples, 64);
+    CHECK(count >= 3 && count <= 14);
+    CHECK(hdc1000_sampler_dropped(p_sampler) == 0);
+    for (i = 0; i < count; i++)
+    {
+        bad += hdc1000_temp_raw_to_centi(samples[i].temp_raw) < 2344 ||
+            hdc1000_temp_raw_to_centi(samples[i].temp_raw) > 2346;
+        bad += hdc1000_humi_raw_to_centi(samples[i].humi_raw) < 4149 ||
+            hdc1000_humi_raw_to_centi(samples[i].humi_raw) > 4151;
+        bad += samples[i].flags != 0;
+        bad += i > 0 &&
+            samples[i].timestamp_us <= samples[i - 1].timestamp_us;
+    }
+    CHECK(bad == 0);
+    CHECK(hdc1000_sampler_drain(p_sampler, samples, 64) == 0);
+    hdc1000_sampler_destroy(p_sampler);
+
+    // Full ring keeps the oldest samples and counts the dropped ones
+    p_sampler = hdc1000_sampler_create(p_hdc, 1000, 2);
+    CHECK(hdc1000_sampler_start(p_sampler) == 0);
+    sleep_ms(30);
+    hdc1000_sampler_stop(p_sampler);
+    CHECK(hdc1000_sampler_drain(p_sampler, samples, 64) == 2);
+    CHECK(samples[0].timestamp_us < samples[1].timestamp_us);
+    CHECK(hdc1000_sampler_dropped(p_sampler) > 0);
+    hdc1000_sampler_destroy(p_sampler);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_filter_hold(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+
+    // Values read while held, as after a heater burst, are not recorded
+    hdc1000_set_filter(p_hdc, 1, 1, 1);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 1000) == 1000);
+    hdc1000_hold_filter(p_hdc, 1);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 3000) == 3000);
+    hdc1000_hold_filter(p_hdc, 0);
+    CHECK(hdc1000_filter_raw(p_hdc, HDC1000_FILTER_TEMP, 1000) == 1000);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_heater(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    hdc1000_sampler_t *p_sampler;
+    hdc1000_sample_t samples[128];
+    int16_t heated_max = INT16_MIN;
+    int16_t idle_max = INT16_MIN;
+    int16_t temp;
+    size_t heated = 0;
+    size_t count;
+    size_t i;
+
+    // Sensor cools down within a period, idle samples read ambient
+    sim.cool_rate = 1000.0;
+    hdc1000_set_filter(p_hdc, 1, 1, 4);
+    hdc1000_set_retry(p_hdc, 0, 0);
+
+    // Burst and blackout samples are flagged, burst heats the sensor
+    p_sampler = hdc1000_sampler_create(p_hdc, 2000, 128);
+    CHECK(p_sampler != NULL);
+    CHECK(hdc1000_sampler_set_heater(p_sampler, 40000, 25, 10000,
+        HDC1000_HEATER_MARK) == 0);
+    CHECK(hdc1000_sampler_start(p_sampler) == 0);
+    CHECK(hdc1000_sampler_set_heater(p_sampler, 0, 0, 0,
+        HDC1000_HEATER_MARK) == -1);
+    sleep_ms(100);
+    hdc1000_sampler_stop(p_sampler);
+
+    count = hdc1000_sampler_drain(p_sampler, samples, 128);
+    for (i = 0; i < count; i++)
+    {
+        temp = hdc1000_temp_raw_to_centi(samples[i].temp_raw);
+        if (samples[i].flags & HDC1000_SAMPLE_HEATED)
+        {
+            heated++;
+            heated_max = (temp > heated_max) ? temp : heated_max;
+        }
+        else
+        {
+            idle_max = (temp > idle_max) ? temp : idle_max;
+        }
+    }
+    CHECK(heated > 0 && heated < count);
+    CHECK(heated_max > 2400);
+    CHECK(idle_max <= 2346);
+
+    // Heater is off and filters record again after stop, heated values
+    // did not reach them
+    CHECK((sim.config_reg & HDC1000_SIM_CFG_HEAT) == 0);
+    CHECK(p_hdc->filter_hold == 0);
+    CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_OK);
+    CHECK(temp >= 2344 && temp <= 2346);
+    hdc1000_sampler_destroy(p_sampler);
+
+    // Suppressed samples are not stored
+    p_sampler = hdc1000_sampler_create(p_hdc, 2000, 128);
+    CHECK(hdc1000_sampler_set_heater(p_sampler, 40000, 25, 10000,
+        HDC1000_HEATER_SUPPRESS) == 0);
+    CHECK(hdc1000_sampler_start(p_sampler) == 0);
+    sleep_ms(100);
+    hdc1000_sampler_stop(p_sampler);
+    count = hdc1000_sampler_drain(p_sampler, samples, 128);
+    CHECK(count > 0);
+    for (i = 0, heated = 0; i < count; i++)
+    {
+        heated += (samples[i].flags & HDC1000_SAMPLE_HEATED) != 0;
+    }
+    CHECK(heated == 0);
+    hdc1000_sampler_destroy(p_sampler);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_sampler_stop();
+    test_sampling();
+    test_filter_hold();
+    test_heater();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
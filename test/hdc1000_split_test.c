@@ -0,0 +1,158 @@
+/***************************************************************************//**
+* @file    hdc1000_split_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 split-phase measurement.
+*
+* @par Description
+*    Runs the trigger, poll and fetch state machine on the simulator with
+*    and without DRDYn, including refused and failed triggers, also when
+*    the platform defers the trigger write.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Helpers
+*******************************************************************************/
+
+/// <summary>
+///     Simulator callback deferring single byte writes until the next
+///     message, like lib_hdc1000_linux.c does
+/// </summary>
+static int
+deferring_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    static uint8_t pending;
+    static uint8_t pending_len;
+    int result = 0;
+
+    if (pending_len > 0 && msg != HDC1000_MSG_I2C_RECOVER)
+    {
+        result = hdc1000_sim_cb(p_hdc, HDC1000_MSG_I2C_WRITE_BYTE, pending,
+            NULL);
+    }
+    pending_len = 0;
+    if (result < 0)
+    {
+        return HDC1000_CB_ERROR;
+    }
+
+    if (msg == HDC1000_MSG_I2C_WRITE_BYTE)
+    {
+        pending = arg_int;
+        pending_len = 1;
+        return HDC1000_CB_OK;
+    }
+    return hdc1000_sim_cb(p_hdc, msg, arg_int, arg_ptr);
+}
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_split_phase(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    uint16_t temp = 0;
+    uint16_t humi = 0;
+    uint32_t remaining = 0;
+    int conv_time;
+
+    CHECK(hdc1000_start_measurement(p_hdc, HDC1000_REG_CONFIG) ==
+        HDC1000_ERR_ARG);
+    CHECK(hdc1000_poll(p_hdc, &remaining) == HDC1000_STATE_IDLE);
+    CHECK(remaining == 0);
+    CHECK(hdc1000_fetch(p_hdc, &temp, &humi) == HDC1000_ERR_NOT_READY);
+
+    hdc1000_set_retry(p_hdc, 0, 0);
+    sim.fail_next = 1;
+    CHECK(hdc1000_start_measurement(p_hdc, HDC1000_REG_TEMP) ==
+        HDC1000_ERR_IO);
+
+    conv_time = hdc1000_start_measurement(p_hdc, HDC1000_REG_TEMP);
+    CHECK(conv_time > 0);
+    CHECK(hdc1000_start_measurement(p_hdc, HDC1000_REG_TEMP) ==
+        HDC1000_ERR_NOT_READY);
+    CHECK(hdc1000_poll(p_hdc, &remaining) == HDC1000_STATE_BUSY);
+    CHECK(remaining > 0 && remaining <= (uint32_t)conv_time);
+    CHECK(hdc1000_fetch(p_hdc, &temp, &humi) == HDC1000_ERR_NOT_READY);
+
+    hdc1000_sim_advance(&sim, remaining);
+    CHECK(hdc1000_poll(p_hdc, &remaining) == HDC1000_STATE_READY);
+    CHECK(remaining == 0);
+    CHECK(hdc1000_fetch(p_hdc, &temp, &humi) == HDC1000_OK);
+    CHECK(hdc1000_temp_raw_to_centi(temp) >= 2344 &&
+        hdc1000_temp_raw_to_centi(temp) <= 2346);
+    CHECK(hdc1000_humi_raw_to_centi(humi) >= 4149 &&
+        hdc1000_humi_raw_to_centi(humi) <= 4151);
+
+    // Result is fetched once
+    CHECK(hdc1000_poll(p_hdc, &remaining) == HDC1000_STATE_IDLE);
+    CHECK(hdc1000_fetch(p_hdc, &temp, &humi) == HDC1000_ERR_NOT_READY);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_split_phase_drdyn(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, DRDYN_PIN);
+    uint16_t humi = 0;
+    uint32_t remaining = 0;
+    int conv_time;
+
+    // DRDYn decides completion, not the expected conversion time
+    CHECK(hdc1000_set_mode(p_hdc, HDC1000_CFG_SINGLE_MEASUR) == 1);
+    conv_time = hdc1000_start_measurement(p_hdc, HDC1000_REG_HUMI);
+    CHECK(conv_time > 0);
+    CHECK(hdc1000_poll(p_hdc, &remaining) == HDC1000_STATE_BUSY);
+    hdc1000_sim_advance(&sim, (uint32_t)conv_time);
+    CHECK(hdc1000_poll(p_hdc, &remaining) == HDC1000_STATE_READY);
+    CHECK(hdc1000_fetch(p_hdc, NULL, &humi) == HDC1000_OK);
+    CHECK(hdc1000_humi_raw_to_centi(humi) >= 4149 &&
+        hdc1000_humi_raw_to_centi(humi) <= 4151);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_deferred_trigger(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc;
+
+    // Deferred trigger write failing on the following message
+    init_sim(&sim);
+    p_hdc = hdc1000_init_user(sim.i2c_addr, -1, deferring_cb, &sim);
+    CHECK(p_hdc != NULL);
+    sim.fail_next = 1;
+    CHECK(hdc1000_start_measurement(p_hdc, HDC1000_REG_TEMP) ==
+        HDC1000_ERR_IO);
+    CHECK(hdc1000_poll(p_hdc, NULL) == HDC1000_STATE_IDLE);
+    CHECK(hdc1000_start_measurement(p_hdc, HDC1000_REG_TEMP) > 0);
+    hdc1000_shutdown(p_hdc);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_split_phase();
+    test_split_phase_drdyn();
+    test_deferred_trigger();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
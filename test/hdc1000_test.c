@@ -0,0 +1,120 @@
+/***************************************************************************//**
+* @file    hdc1000_test.c
+* @version 1.0.0
+*
+* @brief Shared helpers of HDC1000 driver tests.
+*
+* @par Description
+*    Check counting, simulator setup and platform callbacks used by more
+*    than one test program, see hdc1000_test.h.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include <stdio.h>
+#include <time.h>
+
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Variables
+*******************************************************************************/
+
+static int checks;
+static int failures;
+
+/*******************************************************************************
+* Functions
+*******************************************************************************/
+
+/// <summary>
+///     Count check, print it if failed
+/// </summary>
+void
+check(int cond, const char *text, const char *file, int line)
+{
+    checks++;
+    if (!cond)
+    {
+        failures++;
+        printf("%s:%d: check failed: %s\n", file, line, text);
+    }
+}
+
+/// <summary>
+///     Print number of checks and failures
+/// </summary>
+/// <returns>Exit status, 0 if all checks passed</returns>
+int
+check_summary(void)
+{
+    printf("%d checks, %d failed\n", checks, failures);
+    return (failures == 0) ? 0 : 1;
+}
+
+/// <summary>
+///     Initialize simulator with the test environment
+/// </summary>
+void
+init_sim(hdc1000_sim_t *p_sim)
+{
+    hdc1000_sim_init(p_sim);
+    p_sim->ambient_temp = 23.45;
+    p_sim->ambient_humi = 41.5;
+}
+
+/// <summary>
+///     Initialize simulator and open driver on it
+/// </summary>
+hdc1000_t
+*open_sim(hdc1000_sim_t *p_sim, int drdyn_pin)
+{
+    hdc1000_t *p_hdc;
+
+    init_sim(p_sim);
+    p_hdc = hdc1000_sim_open(p_sim, drdyn_pin);
+    CHECK(p_hdc != NULL);
+    return p_hdc;
+}
+
+/// <summary>
+///     Simulator callback of a platform written for the original message
+///     set, returning 1 for every message it does not know
+/// </summary>
+int
+baseline_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    switch (msg)
+    {
+    case HDC1000_MSG_I2C_READ_BYTES:
+    case HDC1000_MSG_I2C_WRITE_BYTE:
+    case HDC1000_MSG_DELAY_MILLI:
+    case HDC1000_MSG_GPIO_MODE_INPUT:
+    case HDC1000_MSG_GPIO_GET_VALUE:
+        if (hdc1000_sim_cb(p_hdc, msg, arg_int, arg_ptr) < 0)
+        {
+            return -1;
+        }
+        break;
+
+    default:
+        break;
+    }
+    return 1;
+}
+
+/// <summary>
+///     Monotonic wall clock time in seconds
+/// </summary>
+double
+wall_time(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,58 @@
+/***************************************************************************//**
+* @file    hdc1000_test.h
+* @version 1.0.0
+*
+* @brief Shared helpers of HDC1000 driver tests.
+*
+* @par Description
+*    Every hdc1000_*_test.c program in this directory tests one area of
+*    the driver against the simulator in hdc1000_sim.c and links
+*    hdc1000_test.c for checks and simulator setup. CHECK() prints failed
+*    checks, check_summary() prints the totals and gives the exit status.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#ifndef __HDC1000_TEST_H__
+#define __HDC1000_TEST_H__
+
+/*******************************************************************************
+*   Included Headers
+*******************************************************************************/
+#include "hdc1000.h"
+#include "hdc1000_sim.h"
+
+/*******************************************************************************
+*   Macros
+*******************************************************************************/
+
+#define CHECK(cond) check((cond), #cond, __FILE__, __LINE__)
+
+#define DRDYN_PIN           1
+
+/*******************************************************************************
+*   Function Declarations
+*******************************************************************************/
+
+void
+check(int cond, const char *text, const char *file, int line);
+
+int
+check_summary(void);
+
+void
+init_sim(hdc1000_sim_t *p_sim);
+
+hdc1000_t
+*open_sim(hdc1000_sim_t *p_sim, int drdyn_pin);
+
+int
+baseline_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+
+double
+wall_time(void);
+
+#endif // __HDC1000_TEST_H__
+/* [] END OF FILE */
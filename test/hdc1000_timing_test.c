@@ -0,0 +1,111 @@
+/***************************************************************************//**
+* @file    hdc1000_timing_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 conversion timing.
+*
+* @par Description
+*    Checks that reads wait for the conversion time of the configured
+*    mode and resolution, and the delay and clock fallbacks on a platform
+*    which supports only the original millisecond delay message.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_conversion_time(void)
+{
+    uint8_t resolutions[] = {
+        HDC1000_CFG_TEMP_HUMI_14BIT,
+        HDC1000_CFG_TEMP_11BIT | HDC1000_CFG_HUMI_11BIT,
+        HDC1000_CFG_TEMP_11BIT | HDC1000_CFG_HUMI_8BIT
+    };
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    uint32_t conv_time;
+    uint32_t last = UINT32_MAX;
+    uint16_t raw;
+    size_t i;
+
+    CHECK(hdc1000_set_mode(p_hdc, HDC1000_CFG_SINGLE_MEASUR) == 1);
+    for (i = 0; i < sizeof(resolutions); i++)
+    {
+        hdc1000_set_resolution(p_hdc, resolutions[i]);
+
+        // Lower resolution converts faster, reads sleep just that long
+        conv_time = hdc1000_get_conversion_time(p_hdc, HDC1000_REG_HUMI);
+        CHECK(conv_time < last);
+        last = conv_time;
+        hdc1000_sim_reset_stats(&sim);
+        CHECK(hdc1000_read_humi_raw(p_hdc, &raw) == HDC1000_OK);
+        CHECK(sim.sleep_us == conv_time);
+    }
+
+    // Combined mode converts both
+    CHECK(hdc1000_set_mode(p_hdc, HDC1000_CFG_BOTH_TEMP_HUMI) == 1);
+    CHECK(hdc1000_get_conversion_time(p_hdc, HDC1000_REG_HUMI) ==
+        HDC1000_CONV_TIME_TEMP_11BIT + HDC1000_CONV_TIME_HUMI_8BIT +
+        HDC1000_CONV_TIME_MARGIN_US);
+    CHECK(hdc1000_get_conversion_time(p_hdc, HDC1000_REG_CONFIG) == 0);
+
+    hdc1000_sim_close(p_hdc);
+}
+
+static void
+test_baseline_platform(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc;
+    int16_t temp = 0;
+    uint16_t humi = 0;
+
+    // Microsecond delays fall back to whole milliseconds
+    init_sim(&sim);
+    p_hdc = hdc1000_init_user(sim.i2c_addr, -1, baseline_cb, &sim);
+    CHECK(p_hdc != NULL);
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_OK);
+    CHECK(temp >= 2344 && temp <= 2346);
+    CHECK(sim.sleep_us > 0 && sim.sleep_us % 1000 == 0);
+
+    // Without clock there is no time budget or split-phase measurement
+    hdc1000_set_timeout(p_hdc, 100000);
+    CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_ERR_UNSUPPORTED);
+    hdc1000_set_timeout(p_hdc, 0);
+    CHECK(hdc1000_start_measurement(p_hdc, HDC1000_REG_TEMP) ==
+        HDC1000_ERR_UNSUPPORTED);
+    CHECK(hdc1000_poll(p_hdc, NULL) == HDC1000_STATE_IDLE);
+    hdc1000_shutdown(p_hdc);
+
+    // DRDYn polling counts slept time instead of reading the clock
+    p_hdc = hdc1000_init_user(sim.i2c_addr, DRDYN_PIN, baseline_cb, &sim);
+    CHECK(hdc1000_read_humi_centi(p_hdc, &humi) == HDC1000_OK);
+    CHECK(humi >= 4149 && humi <= 4151);
+    sim.drdyn_stuck = 1;
+    hdc1000_set_retry(p_hdc, 0, 0);
+    CHECK(hdc1000_read_humi_centi(p_hdc, &humi) == HDC1000_ERR_TIMEOUT);
+    hdc1000_shutdown(p_hdc);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_conversion_time();
+    test_baseline_platform();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,115 @@
+/***************************************************************************//**
+* @file    hdc1000_transaction_test.c
+* @version 1.0.0
+*
+* @brief Tests of HDC1000 register access transactions.
+*
+* @par Description
+*    Reads registers with HDC1000_MSG_TRANSACTION on the simulator and
+*    checks the fallback to single-step messages on platforms that do not
+*    run transactions or DRDYn wait segments.
+*
+* @author
+*
+* @date
+*
+*******************************************************************************/
+#include "hdc1000_test.h"
+
+/*******************************************************************************
+* Helpers
+*******************************************************************************/
+
+/// <summary>
+///     Simulator callback acknowledging transactions without running them
+/// </summary>
+static int
+lax_transaction_cb(hdc1000_t *p_hdc, uint8_t msg, uint8_t arg_int,
+    void *arg_ptr)
+{
+    if (msg == HDC1000_MSG_TRANSACTION)
+    {
+        return 1;
+    }
+    return hdc1000_sim_cb(p_hdc, msg, arg_int, arg_ptr);
+}
+
+/*******************************************************************************
+* Tests
+*******************************************************************************/
+
+static void
+test_transaction_fallback(void)
+{
+    hdc1000_sim_t sim;
+    hdc1000_t *p_hdc = open_sim(&sim, -1);
+    int16_t temp = 0;
+    uint16_t humi = 0;
+    uint16_t config = 0;
+
+    // Transactions are declared by the platform wrapper
+    CHECK(p_hdc->transaction != 0);
+
+    // Platform without transactions
+    sim.transaction_msgs = 0;
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_OK);
+    CHECK(p_hdc->transaction == 0);
+    CHECK(sim.msg_count > 1);
+    CHECK(temp >= 2344 && temp <= 2346);
+    hdc1000_sim_close(p_hdc);
+
+    // Transactions without DRDYn edge events, DRDYn is polled for this
+    // access only
+    p_hdc = open_sim(&sim, DRDYN_PIN);
+    sim.edge_events = 0;
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_read_humi_centi(p_hdc, &humi) == HDC1000_OK);
+    CHECK(p_hdc->transaction != 0);
+    CHECK(sim.wait_us == 0);
+    CHECK(humi >= 4149 && humi <= 4151);
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_read_config(p_hdc, &config) == HDC1000_OK);
+    CHECK(sim.msg_count == 2);      // Transaction and battery cache time
+    hdc1000_sim_close(p_hdc);
+
+    // Transactions with edge events take one message per read
+    p_hdc = open_sim(&sim, DRDYN_PIN);
+    hdc1000_sim_reset_stats(&sim);
+    CHECK(hdc1000_read_humi_centi(p_hdc, &humi) == HDC1000_OK);
+    CHECK(p_hdc->transaction != 0);
+    CHECK(sim.msg_count == 1);
+    CHECK(sim.wait_us > 0);
+    hdc1000_sim_close(p_hdc);
+
+    // Transactions are off unless declared
+    hdc1000_sim_init(&sim);
+    sim.ambient_temp = 23.45;
+    p_hdc = hdc1000_init_user(sim.i2c_addr, -1, hdc1000_sim_cb, &sim);
+    CHECK(p_hdc != NULL);
+    CHECK(p_hdc->transaction == 0);
+    hdc1000_shutdown(p_hdc);
+
+    // Positive result of unknown message is not success
+    p_hdc = hdc1000_init_user(sim.i2c_addr, -1, lax_transaction_cb, &sim);
+    hdc1000_set_transaction(p_hdc, 1);
+    temp = 0;
+    CHECK(hdc1000_read_temp_centi(p_hdc, &temp) == HDC1000_OK);
+    CHECK(p_hdc->transaction == 0);
+    CHECK(temp >= 2344 && temp <= 2346);
+    hdc1000_shutdown(p_hdc);
+}
+
+/*******************************************************************************
+* Main
+*******************************************************************************/
+
+int
+main(void)
+{
+    test_transaction_fallback();
+
+    return check_summary();
+}
+
+/* [] END OF FILE */